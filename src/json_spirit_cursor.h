@@ -0,0 +1,384 @@
+#ifndef JSON_SPIRIT_CURSOR
+#define JSON_SPIRIT_CURSOR
+
+//          Copyright John W. Wilkinson 2007 - 2014
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+
+// json spirit version 4.08
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include "json_spirit_reader_template.h"
+
+namespace json_spirit
+{
+enum Token_type
+{
+    no_token, // next() has not been called yet
+    begin_obj_token,
+    end_obj_token,
+    begin_array_token,
+    end_array_token,
+    name_token, // the name of a pair, its value is the next token
+    str_token,
+    number_token,
+    bool_token,
+    null_token,
+    end_token // the whole text has been read
+};
+
+// A Json_cursor steps through a JSON text one token at a time, reading no further
+// than asked to, e.g. to look at the first pairs of an object and stop
+//
+// Json_cursor< string > cursor( str );
+// cursor.next(); // begin_obj_token
+// while( cursor.next() == name_token )
+// {
+//     if( cursor.get_str() == "route" && cursor.next() == str_token ) return cursor.get_str();
+//     cursor.skip(); // the value of the pair, however large
+// }
+//
+// Values can also be read whole with get_value(). The text is checked as it is
+// read, with the same rules as read(), and std::runtime_error is thrown at the
+// first error. The cursor keeps pointers into the text, which must outlive it.
+//
+template<class String_type>
+class Json_cursor
+{
+public:
+    typedef typename String_type::value_type Char_type;
+
+    Json_cursor(const Char_type* begin, const Char_type* end)
+        : lexer_(begin, end)
+        , token_(no_token)
+        , token_begin_(begin)
+        , token_end_(begin)
+        , expect_(expect_root)
+    {
+        number_.kind = not_a_number;
+    }
+
+    explicit Json_cursor(const String_type& s)
+        : Json_cursor(s.data(), s.data() + s.size())
+    {
+    }
+
+    // moves to the next token and returns its type, end_token once the text has been read
+    //
+    Token_type next()
+    {
+        switch (expect_)
+        {
+        case expect_root:
+            read_value_token("not a value");
+            break;
+        case expect_first_element:
+            lexer_.skip_space_and_comments();
+            if (!read_end_token(']', end_array_token))
+            {
+                read_value_token("not an array");
+            }
+            break;
+        case expect_element:
+            read_value_token("not an array");
+            break;
+        case expect_first_pair:
+            lexer_.skip_space_and_comments();
+            if (!read_end_token('}', end_obj_token))
+            {
+                read_name_token("not an object");
+            }
+            break;
+        case expect_pair:
+            read_name_token("not an object");
+            break;
+        case expect_colon:
+            lexer_.skip_space_and_comments();
+            if (!lexer_.consume(':'))
+            {
+                throw_error(lexer_.pos(), "no colon in pair");
+            }
+            read_value_token("not a value");
+            break;
+        case expect_separator:
+            read_separator();
+            break;
+        case expect_end:
+            read_end();
+            break;
+        }
+        return token_;
+    }
+
+    Token_type token() const { return token_; }
+
+    // number of objects and arrays the current token is in, a begin token counts
+    // the container it begins, an end token does not
+    //
+    std::size_t depth() const { return stack_.size(); }
+
+    // the characters of the current token, strings and names include their quotes
+    //
+    const Char_type* token_begin() const { return token_begin_; }
+    const Char_type* token_end() const { return token_end_; }
+
+    // of a name_token or str_token
+    //
+    String_type get_str() const
+    {
+        assert(token_ == name_token || token_ == str_token);
+
+        return json_spirit::get_str<String_type>(token_begin_, token_end_);
+    }
+
+    // of a number_token, whether it is a double, an int64 or an uint64
+    //
+    const Json_number& get_number() const
+    {
+        assert(token_ == number_token);
+
+        return number_;
+    }
+
+    // of a bool_token
+    //
+    bool get_bool() const
+    {
+        assert(token_ == bool_token);
+
+        return *token_begin_ == 't';
+    }
+
+    // Skips the value of a name_token or the rest of the object or array
+    // begun by a begin token, the current token is then the last token of
+    // the value. Does nothing for other tokens.
+    //
+    void skip()
+    {
+        if (token_ == name_token)
+        {
+            next();
+        }
+
+        if (token_ == begin_obj_token || token_ == begin_array_token)
+        {
+            const std::size_t depth = stack_.size();
+
+            while (stack_.size() >= depth)
+            {
+                next();
+            }
+        }
+    }
+
+    // Reads the value starting at the current token, or following the current
+    // name_token, into value. Afterwards the current token is the last token
+    // of the value, as with skip().
+    //
+    template<class Value_type>
+    void get_value(Value_type& value)
+    {
+        if (token_ == name_token)
+        {
+            next();
+        }
+
+        assert(token_ != no_token && token_ != end_token && token_ != end_obj_token && token_ != end_array_token);
+
+        if (token_ == begin_obj_token || token_ == begin_array_token)
+        {
+            stack_.pop_back();
+        }
+
+        Semantic_actions<Value_type, const Char_type*> semantic_actions(value);
+        Json_fast_parser<Semantic_actions<Value_type, const Char_type*>, Char_type> parser(semantic_actions,
+            token_begin_, lexer_.end());
+
+        token_end_ = parser.parse();
+        lexer_.set_pos(token_end_);
+
+        if (token_ == begin_obj_token)
+        {
+            token_ = end_obj_token;
+            token_begin_ = token_end_ - 1;
+        }
+        else if (token_ == begin_array_token)
+        {
+            token_ = end_array_token;
+            token_begin_ = token_end_ - 1;
+        }
+
+        end_value();
+    }
+
+private:
+    enum Expectation
+    {
+        expect_root,
+        expect_first_element, // a value or ']'
+        expect_element, // a value after ','
+        expect_first_pair, // a name or '}'
+        expect_pair, // a name after ','
+        expect_colon, // ':' then a value
+        expect_separator, // ',' or the end of the current object or array
+        expect_end
+    };
+
+    void set_token(Token_type token, const Char_type* begin)
+    {
+        token_ = token;
+        token_begin_ = begin;
+        token_end_ = lexer_.pos();
+    }
+
+    void end_value()
+    {
+        expect_ = stack_.empty() ? expect_end : expect_separator;
+    }
+
+    void read_value_token(const char* error)
+    {
+        lexer_.skip_space_and_comments();
+
+        if (lexer_.at_end())
+        {
+            throw_error(lexer_.pos(), error);
+        }
+
+        const Char_type* const first = lexer_.pos();
+        const Char_type* string_first = nullptr;
+        const Char_type* string_last = nullptr;
+
+        switch (lexer_.peek())
+        {
+        case '"':
+            if (!lexer_.scan_string(string_first, string_last))
+            {
+                throw_error(first, error);
+            }
+            set_token(str_token, first);
+            end_value();
+            return;
+        case '{':
+            lexer_.consume('{');
+            set_token(begin_obj_token, first);
+            stack_.push_back('}');
+            expect_ = expect_first_pair;
+            return;
+        case '[':
+            lexer_.consume('[');
+            set_token(begin_array_token, first);
+            stack_.push_back(']');
+            expect_ = expect_first_element;
+            return;
+        case 't':
+            read_literal("true", bool_token, error);
+            return;
+        case 'f':
+            read_literal("false", bool_token, error);
+            return;
+        case 'n':
+            read_literal("null", null_token, error);
+            return;
+        default:
+            if (!lexer_.scan_number(number_))
+            {
+                throw_error(first, error);
+            }
+            set_token(number_token, first);
+            end_value();
+            return;
+        }
+    }
+
+    void read_literal(const char* literal, Token_type token, const char* error)
+    {
+        const Char_type* const first = lexer_.pos();
+
+        if (!lexer_.scan_literal(literal))
+        {
+            throw_error(first, error);
+        }
+        set_token(token, first);
+        end_value();
+    }
+
+    void read_name_token(const char* error)
+    {
+        lexer_.skip_space_and_comments();
+
+        const Char_type* const first = lexer_.pos();
+        const Char_type* string_first = nullptr;
+        const Char_type* string_last = nullptr;
+
+        if (lexer_.at_end() || lexer_.peek() != '"' || !lexer_.scan_string(string_first, string_last))
+        {
+            throw_error(first, error);
+        }
+        set_token(name_token, first);
+        expect_ = expect_colon;
+    }
+
+    bool read_end_token(Char_type c, Token_type token)
+    {
+        const Char_type* const first = lexer_.pos();
+
+        if (!lexer_.consume(c))
+        {
+            return false;
+        }
+        stack_.pop_back();
+        set_token(token, first);
+        end_value();
+        return true;
+    }
+
+    void read_separator()
+    {
+        const bool in_obj = (stack_.back() == '}');
+
+        lexer_.skip_space_and_comments();
+
+        if (lexer_.consume(','))
+        {
+            if (in_obj)
+            {
+                read_name_token("not an object");
+            }
+            else
+            {
+                read_value_token("not an array");
+            }
+        }
+        else if (!read_end_token(in_obj ? '}' : ']', in_obj ? end_obj_token : end_array_token))
+        {
+            throw_error(lexer_.pos(), in_obj ? "not an object" : "not an array");
+        }
+    }
+
+    // like read(), only white space may follow the value
+    //
+    void read_end()
+    {
+        lexer_.skip_space();
+
+        if (!lexer_.at_end())
+        {
+            throw_error(lexer_.pos(), "unexpected trailing characters");
+        }
+        set_token(end_token, lexer_.pos());
+    }
+
+    Json_lexer<Char_type> lexer_;
+    Token_type token_;
+    const Char_type* token_begin_;
+    const Char_type* token_end_;
+    Json_number number_;
+    Expectation expect_;
+    std::vector<Char_type> stack_; // the closing bracket of each object or array the cursor is in
+};
+}
+
+#endif
@@ -0,0 +1,802 @@
+#ifndef JSON_SPIRIT_HASH_OBJECT
+#define JSON_SPIRIT_HASH_OBJECT
+
+//          Copyright John W. Wilkinson 2007 - 2014
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+
+// json spirit version 4.08
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include <boost/functional/hash.hpp>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace json_spirit
+{
+template<class Char_type>
+class Interned_string;
+
+// hashes names with std::hash, or boost::hash_range for string views, interned strings know
+// their hash already; it is looked up when an object is used, as the pair type of an object is incomplete when its Config is declared
+//
+struct Name_hash
+{
+    template<class Char_type>
+    std::size_t operator()(const Interned_string<Char_type>& name) const
+    {
+        return name.hash(); // computed once, when the string was interned
+    }
+
+    template<class Char_type, class Traits>
+    std::size_t operator()(const std::basic_string<Char_type, Traits>& name) const
+    {
+        return std::hash<std::basic_string<Char_type, Traits>>()(name);
+    }
+
+    template<class String_type>
+    std::size_t operator()(const String_type& name) const
+    {
+        return boost::hash_range(name.begin(), name.end());
+    }
+};
+
+// An open addressing hash table over the names of a vector of pairs, whose slots hold the
+// position of a pair and 32 bits of the hash of its name. The table is kept at most half full.
+//
+template<class Allocator, class Hash = Name_hash>
+class Name_index
+{
+public:
+    explicit Name_index(const Allocator& allocator = Allocator())
+        : slots_(Slot_allocator(allocator))
+    {
+    }
+
+    bool empty() const
+    {
+        return slots_.empty();
+    }
+
+    void clear()
+    {
+        slots_.clear();
+    }
+
+    void swap(Name_index& other)
+    {
+        slots_.swap(other.slots_);
+    }
+
+    // indexes every pair, hashing all the names
+    //
+    template<class Pairs>
+    void build(const Pairs& pairs)
+    {
+        slots_.assign(slot_count(pairs.size()), Slot());
+
+        for (std::size_t i = 0; i != pairs.size(); ++i)
+        {
+            add_slot(slots_, static_cast<std::uint32_t>(i + 1), hash_name(pairs[i].name_));
+        }
+    }
+
+    // indexes the last pair after it has been appended
+    //
+    template<class Pairs>
+    void add_last(const Pairs& pairs)
+    {
+        const std::size_t size = pairs.size();
+
+        if (size * 2 > slots_.size())
+        {
+            grow(size);
+        }
+
+        add_slot(slots_, static_cast<std::uint32_t>(size), hash_name(pairs.back().name_));
+    }
+
+    // returns the position of the pair with the name, or pairs.size() if there is none
+    //
+    template<class Pairs, class String_type>
+    std::size_t find(const Pairs& pairs, const String_type& name) const
+    {
+        const std::uint32_t hash = hash_name(name);
+        const std::size_t mask = slots_.size() - 1;
+
+        for (std::size_t i = hash & mask;; i = (i + 1) & mask)
+        {
+            const Slot& slot = slots_[i];
+
+            if (slot.pos_plus_1_ == 0)
+            {
+                return pairs.size();
+            }
+
+            if (slot.hash_ == hash && pairs[slot.pos_plus_1_ - 1].name_ == name)
+            {
+                return slot.pos_plus_1_ - 1;
+            }
+        }
+    }
+
+private:
+    struct Slot
+    {
+        std::uint32_t pos_plus_1_; // 0 for an empty slot
+        std::uint32_t hash_;
+    };
+
+    typedef typename std::allocator_traits<Allocator>::template rebind_alloc<Slot> Slot_allocator;
+    typedef std::vector<Slot, Slot_allocator> Slots;
+
+    template<class String_type>
+    static std::uint32_t hash_name(const String_type& name)
+    {
+        const std::size_t hash = Hash()(name);
+
+        return static_cast<std::uint32_t>(hash ^ (hash >> 16 >> 16));
+    }
+
+    static std::size_t slot_count(std::size_t size)
+    {
+        std::size_t n = 16;
+
+        while (n < size * 4)
+        {
+            n *= 2;
+        }
+
+        return n;
+    }
+
+    static void add_slot(Slots& slots, std::uint32_t pos_plus_1, std::uint32_t hash)
+    {
+        const std::size_t mask = slots.size() - 1;
+
+        std::size_t i = hash & mask;
+
+        while (slots[i].pos_plus_1_ != 0)
+        {
+            i = (i + 1) & mask;
+        }
+
+        slots[i].pos_plus_1_ = pos_plus_1;
+        slots[i].hash_ = hash;
+    }
+
+    // moves the slots to a larger table, their hashes are kept so names are not hashed again;
+    // they are added in the order of the pairs, so of pairs with the same name the first is still
+    // found first, as it would be by a linear search or after build()
+    //
+    void grow(std::size_t size)
+    {
+        Slots by_pos(size, Slot(), slots_.get_allocator());
+
+        for (const Slot& slot : slots_)
+        {
+            if (slot.pos_plus_1_ != 0)
+            {
+                by_pos[slot.pos_plus_1_ - 1] = slot;
+            }
+        }
+
+        Slots slots(slot_count(size), Slot(), slots_.get_allocator());
+
+        for (const Slot& slot : by_pos)
+        {
+            if (slot.pos_plus_1_ != 0)
+            {
+                add_slot(slots, slot.pos_plus_1_, slot.hash_);
+            }
+        }
+
+        slots_.swap(slots);
+    }
+
+    Slots slots_;
+};
+
+// A Hash_object keeps the pairs of a JSON object in the order they were added, like a
+// vector object, and finds them by name in constant time, like a map object.
+//
+// The pairs are held in a vector. Objects with more than a few pairs also carry a
+// Name_index, so iterating, copying and writing an object is as cheap as for a vector.
+// Adding a pair whose name is already present assigns the existing pair instead, the last
+// value read wins but the pair keeps its first position.
+//
+// The names of the pairs must not be changed through an iterator, the index would not know.
+//
+template<class Pair_type, class Allocator = std::allocator<Pair_type>, class Hash = Name_hash>
+class Hash_object
+{
+public:
+    typedef Pair_type value_type;
+    typedef typename Pair_type::String_type String_type;
+    typedef typename Pair_type::Value_type Value_type;
+    typedef Allocator allocator_type;
+    typedef std::vector<Pair_type, Allocator> Pairs;
+    typedef typename Pairs::size_type size_type;
+    typedef typename Pairs::iterator iterator;
+    typedef typename Pairs::const_iterator const_iterator;
+
+    explicit Hash_object(const allocator_type& allocator = allocator_type())
+        : pairs_(allocator)
+        , index_(allocator)
+    {
+    }
+
+    Hash_object(std::initializer_list<Pair_type> pairs, const allocator_type& allocator = allocator_type())
+        : pairs_(allocator)
+        , index_(allocator)
+    {
+        reserve(pairs.size());
+
+        for (const Pair_type& pair : pairs)
+        {
+            insert(pair);
+        }
+    }
+
+    allocator_type get_allocator() const
+    {
+        return pairs_.get_allocator();
+    }
+
+    iterator begin() { return pairs_.begin(); }
+    iterator end() { return pairs_.end(); }
+    const_iterator begin() const { return pairs_.begin(); }
+    const_iterator end() const { return pairs_.end(); }
+
+    size_type size() const { return pairs_.size(); }
+    bool empty() const { return pairs_.empty(); }
+
+    void reserve(size_type n)
+    {
+        pairs_.reserve(n);
+    }
+
+    void clear()
+    {
+        pairs_.clear();
+        index_.clear();
+    }
+
+    iterator find(const String_type& name)
+    {
+        return pairs_.begin() + find_pos(name);
+    }
+
+    const_iterator find(const String_type& name) const
+    {
+        return pairs_.begin() + find_pos(name);
+    }
+
+    size_type count(const String_type& name) const
+    {
+        return find_pos(name) != pairs_.size() ? 1 : 0;
+    }
+
+    Value_type& at(const String_type& name)
+    {
+        const size_type pos = find_pos(name);
+
+        if (pos == pairs_.size())
+        {
+            throw std::out_of_range("json_spirit::Hash_object::at");
+        }
+
+        return pairs_[pos].value_;
+    }
+
+    const Value_type& at(const String_type& name) const
+    {
+        return const_cast<Hash_object*>(this)->at(name);
+    }
+
+    Value_type& operator[](const String_type& name)
+    {
+        const size_type pos = find_pos(name);
+
+        if (pos != pairs_.size())
+        {
+            return pairs_[pos].value_;
+        }
+
+        return append(Pair_type(name, Value_type()))->value_;
+    }
+
+    // adds the pair unless its name is present, as for std::map
+    //
+    std::pair<iterator, bool> insert(const Pair_type& pair)
+    {
+        return insert(Pair_type(pair));
+    }
+
+    std::pair<iterator, bool> insert(Pair_type&& pair)
+    {
+        const size_type pos = find_pos(pair.name_);
+
+        if (pos != pairs_.size())
+        {
+            return std::make_pair(pairs_.begin() + pos, false);
+        }
+
+        return std::make_pair(append(std::move(pair)), true);
+    }
+
+    template<class... Args>
+    std::pair<iterator, bool> emplace(Args&&... args)
+    {
+        return insert(Pair_type(std::forward<Args>(args)...));
+    }
+
+    // adds the pair or, if its name is present, assigns the value of the existing pair
+    //
+    std::pair<iterator, bool> insert_or_assign(const String_type& name, const Value_type& value)
+    {
+        return insert_or_assign(String_type(name), Value_type(value));
+    }
+
+    std::pair<iterator, bool> insert_or_assign(String_type&& name, Value_type&& value)
+    {
+        const size_type pos = find_pos(name);
+
+        if (pos != pairs_.size())
+        {
+            pairs_[pos].value_ = std::move(value);
+
+            return std::make_pair(pairs_.begin() + pos, false);
+        }
+
+        return std::make_pair(append(Pair_type(std::move(name), std::move(value))), true);
+    }
+
+    iterator erase(const_iterator pos)
+    {
+        const iterator next = pairs_.erase(pos);
+
+        rebuild_index();
+
+        return next;
+    }
+
+    size_type erase(const String_type& name)
+    {
+        const size_type pos = find_pos(name);
+
+        if (pos == pairs_.size())
+        {
+            return 0;
+        }
+
+        erase(pairs_.begin() + pos);
+
+        return 1;
+    }
+
+    void swap(Hash_object& other)
+    {
+        pairs_.swap(other.pairs_);
+        index_.swap(other.index_);
+    }
+
+    bool operator==(const Hash_object& other) const
+    {
+        return pairs_ == other.pairs_;
+    }
+
+    bool operator!=(const Hash_object& other) const
+    {
+        return !(*this == other);
+    }
+
+private:
+    // objects smaller than this are searched linearly and have no index
+    //
+    static const size_type index_min_size = 8;
+
+    size_type find_pos(const String_type& name) const
+    {
+        if (index_.empty())
+        {
+            for (size_type i = 0; i != pairs_.size(); ++i)
+            {
+                if (pairs_[i].name_ == name)
+                {
+                    return i;
+                }
+            }
+
+            return pairs_.size();
+        }
+
+        return index_.find(pairs_, name);
+    }
+
+    iterator append(Pair_type&& pair)
+    {
+        pairs_.push_back(std::move(pair));
+
+        if (!index_.empty())
+        {
+            index_.add_last(pairs_);
+        }
+        else if (pairs_.size() >= index_min_size)
+        {
+            index_.build(pairs_);
+        }
+
+        return pairs_.end() - 1;
+    }
+
+    // hashes every name again, after pairs have been erased
+    //
+    void rebuild_index()
+    {
+        if (pairs_.size() < index_min_size)
+        {
+            index_.clear();
+        }
+        else
+        {
+            index_.build(pairs_);
+        }
+    }
+
+    Pairs pairs_;
+    Name_index<Allocator, Hash> index_;
+};
+
+// A Vector_object is the std::vector of pairs of a vector object, whose find() builds a
+// Name_index the first time a large object is searched. The index is kept with the object
+// until the pairs are changed, so objects that are searched for many names cost one pass
+// over the names rather than one per name. Small objects are always searched linearly.
+//
+// Any non-const access to the pairs, other than find() and appending pairs, drops the index
+// as the names might be changed; that includes the non-const begin(), end() and operator[],
+// so a lookup after one of them hashes every name again, in O(n). Iterate a const reference,
+// or pairs(), to keep the index. The name of a pair found by the non-const find() must not
+// be changed. Concurrent calls to the const members are safe, as for std::vector, whichever
+// thread builds the index first shares it with the others.
+//
+// The vector is a private base, so an object does not convert to a std::vector of pairs;
+// pairs() gives a const reference to it for code that takes one.
+//
+template<class Pair_type, class Allocator = std::allocator<Pair_type>>
+class Vector_object : private std::vector<Pair_type, Allocator>
+{
+    typedef std::vector<Pair_type, Allocator> Pairs;
+    typedef Name_index<Allocator> Index;
+
+public:
+    using typename Pairs::value_type;
+    using typename Pairs::allocator_type;
+    using typename Pairs::size_type;
+    using typename Pairs::difference_type;
+    using typename Pairs::reference;
+    using typename Pairs::const_reference;
+    using typename Pairs::pointer;
+    using typename Pairs::const_pointer;
+    using typename Pairs::iterator;
+    using typename Pairs::const_iterator;
+    using typename Pairs::reverse_iterator;
+    using typename Pairs::const_reverse_iterator;
+
+    typedef typename Pair_type::String_type String_type;
+    typedef typename Pair_type::Value_type Value_type;
+
+    Vector_object()
+        : index_(nullptr)
+    {
+    }
+
+    explicit Vector_object(const allocator_type& allocator)
+        : Pairs(allocator)
+        , index_(nullptr)
+    {
+    }
+
+    template<class Iter>
+    Vector_object(Iter first, Iter last, const allocator_type& allocator = allocator_type())
+        : Pairs(first, last, allocator)
+        , index_(nullptr)
+    {
+    }
+
+    Vector_object(std::initializer_list<value_type> pairs, const allocator_type& allocator = allocator_type())
+        : Pairs(pairs, allocator)
+        , index_(nullptr)
+    {
+    }
+
+    Vector_object(const Vector_object& other)
+        : Pairs(other)
+        , index_(nullptr)
+    {
+    }
+
+    // the pairs keep their positions, so the index moves with them
+    //
+    Vector_object(Vector_object&& other) noexcept
+        : Pairs(std::move(other))
+        , index_(other.index_.exchange(nullptr, std::memory_order_relaxed))
+    {
+    }
+
+    ~Vector_object()
+    {
+        delete index_.load(std::memory_order_relaxed);
+    }
+
+    Vector_object& operator=(const Vector_object& other)
+    {
+        invalidate();
+        Pairs::operator=(other);
+
+        return *this;
+    }
+
+    Vector_object& operator=(Vector_object&& other) noexcept
+    {
+        invalidate();
+        Pairs::operator=(std::move(other));
+        index_.store(other.index_.exchange(nullptr, std::memory_order_relaxed), std::memory_order_relaxed);
+
+        return *this;
+    }
+
+    Vector_object& operator=(std::initializer_list<value_type> pairs)
+    {
+        invalidate();
+        Pairs::operator=(pairs);
+
+        return *this;
+    }
+
+    using Pairs::get_allocator;
+    using Pairs::size;
+    using Pairs::max_size;
+    using Pairs::capacity;
+    using Pairs::empty;
+    using Pairs::reserve;
+    using Pairs::shrink_to_fit;
+    using Pairs::cbegin;
+    using Pairs::cend;
+    using Pairs::crbegin;
+    using Pairs::crend;
+
+    // the const overloads of these are used as they are, the others drop the index
+
+    using Pairs::begin;
+    using Pairs::end;
+    using Pairs::rbegin;
+    using Pairs::rend;
+    using Pairs::operator[];
+    using Pairs::at;
+    using Pairs::front;
+    using Pairs::back;
+    using Pairs::data;
+
+    iterator begin() { invalidate(); return Pairs::begin(); }
+    iterator end() { invalidate(); return Pairs::end(); }
+    reverse_iterator rbegin() { invalidate(); return Pairs::rbegin(); }
+    reverse_iterator rend() { invalidate(); return Pairs::rend(); }
+    reference operator[](size_type n) { invalidate(); return Pairs::operator[](n); }
+    reference at(size_type n) { invalidate(); return Pairs::at(n); }
+    reference front() { invalidate(); return Pairs::front(); }
+    reference back() { invalidate(); return Pairs::back(); }
+    value_type* data() { invalidate(); return Pairs::data(); }
+
+    // appended pairs are added to the index, if there is one
+
+    void push_back(const value_type& pair)
+    {
+        Pairs::push_back(pair);
+        appended();
+    }
+
+    void push_back(value_type&& pair)
+    {
+        Pairs::push_back(std::move(pair));
+        appended();
+    }
+
+    template<class... Args>
+    reference emplace_back(Args&&... args)
+    {
+        Pairs::emplace_back(std::forward<Args>(args)...);
+        appended();
+
+        return *(Pairs::end() - 1);
+    }
+
+    void pop_back()
+    {
+        invalidate();
+        Pairs::pop_back();
+    }
+
+    template<class... Args>
+    iterator insert(const_iterator pos, Args&&... args)
+    {
+        invalidate();
+        return Pairs::insert(pos, std::forward<Args>(args)...);
+    }
+
+    iterator insert(const_iterator pos, std::initializer_list<value_type> pairs)
+    {
+        invalidate();
+        return Pairs::insert(pos, pairs);
+    }
+
+    template<class... Args>
+    iterator emplace(const_iterator pos, Args&&... args)
+    {
+        invalidate();
+        return Pairs::emplace(pos, std::forward<Args>(args)...);
+    }
+
+    iterator erase(const_iterator pos)
+    {
+        invalidate();
+        return Pairs::erase(pos);
+    }
+
+    iterator erase(const_iterator first, const_iterator last)
+    {
+        invalidate();
+        return Pairs::erase(first, last);
+    }
+
+    template<class... Args>
+    void assign(Args&&... args)
+    {
+        invalidate();
+        Pairs::assign(std::forward<Args>(args)...);
+    }
+
+    void assign(std::initializer_list<value_type> pairs)
+    {
+        invalidate();
+        Pairs::assign(pairs);
+    }
+
+    template<class... Args>
+    void resize(Args&&... args)
+    {
+        invalidate();
+        Pairs::resize(std::forward<Args>(args)...);
+    }
+
+    void clear()
+    {
+        invalidate();
+        Pairs::clear();
+    }
+
+    void swap(Vector_object& other)
+    {
+        Pairs::swap(other);
+        index_.store(other.index_.exchange(index_.load(std::memory_order_relaxed), std::memory_order_relaxed),
+            std::memory_order_relaxed);
+    }
+
+    // lookup by name, building the index if the object is large
+
+    const_iterator find(const String_type& name) const
+    {
+        return Pairs::begin() + find_pos(name);
+    }
+
+    iterator find(const String_type& name)
+    {
+        return Pairs::begin() + find_pos(name);
+    }
+
+    size_type count(const String_type& name) const
+    {
+        return find_pos(name) != size() ? 1 : 0;
+    }
+
+    friend bool operator==(const Vector_object& lhs, const Vector_object& rhs)
+    {
+        return lhs.pairs() == rhs.pairs();
+    }
+
+    friend bool operator!=(const Vector_object& lhs, const Vector_object& rhs)
+    {
+        return lhs.pairs() != rhs.pairs();
+    }
+
+    friend void swap(Vector_object& lhs, Vector_object& rhs)
+    {
+        lhs.swap(rhs);
+    }
+
+    // the pairs as a std::vector, reading them does not drop the index
+    //
+    const Pairs& pairs() const
+    {
+        return *this;
+    }
+
+private:
+    // objects smaller than this are searched linearly and never indexed
+    //
+    static const size_type index_min_size = 16;
+
+    size_type find_pos(const String_type& name) const
+    {
+        const Pairs& pairs = *this;
+
+        if (pairs.size() < index_min_size)
+        {
+            for (size_type i = 0; i != pairs.size(); ++i)
+            {
+                if (pairs[i].name_ == name)
+                {
+                    return i;
+                }
+            }
+
+            return pairs.size();
+        }
+
+        const Index* index = index_.load(std::memory_order_acquire);
+
+        if (index == nullptr)
+        {
+            index = build_index();
+        }
+
+        return index->find(pairs, name);
+    }
+
+    const Index* build_index() const
+    {
+        std::unique_ptr<Index> index(new Index(get_allocator()));
+
+        index->build(pairs());
+
+        Index* expected = nullptr;
+
+        if (index_.compare_exchange_strong(expected, index.get(), std::memory_order_acq_rel, std::memory_order_acquire))
+        {
+            return index.release();
+        }
+
+        return expected; // built by another thread
+    }
+
+    void appended()
+    {
+        if (Index* index = index_.load(std::memory_order_relaxed))
+        {
+            index->add_last(pairs());
+        }
+    }
+
+    void invalidate()
+    {
+        if (index_.load(std::memory_order_relaxed) != nullptr)
+        {
+            delete index_.exchange(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    mutable std::atomic<Index*> index_;
+};
+}
+
+#endif
@@ -0,0 +1,644 @@
+#ifndef JSON_SPIRIT_NUMBER_FORMATTER
+#define JSON_SPIRIT_NUMBER_FORMATTER
+
+//          Copyright John W. Wilkinson 2007 - 2014
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+
+// json spirit version 4.08
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+// Formats the numbers written by the generator straight into a character buffer.
+//
+// Integers are written two digits at a time from a table, after counting their digits
+// from their bit length, so there is one division per pair of digits and few branches.
+//
+// Doubles are converted with the Grisu2 algorithm of Florian Loitsch, "Printing
+// Floating-Point Numbers Quickly and Accurately with Integers", PLDI 2010. The digits
+// always read back as the same double and are the shortest that do in all but a tiny
+// fraction of cases, e.g. 0.1 rather than 0.10000000000000001.
+
+#include "json_spirit_number_parser.h"
+
+#include <boost/cstdint.hpp>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+
+namespace json_spirit
+{
+namespace number_formatter
+{
+// a floating point number f * 2^e with a 64 bit significand
+//
+struct Diy_fp
+{
+    Diy_fp(boost::uint64_t f_, int e_)
+        : f(f_)
+        , e(e_)
+    {
+    }
+
+    // x - y, where x >= y and both have the same exponent
+    //
+    static Diy_fp sub(const Diy_fp& x, const Diy_fp& y)
+    {
+        assert(x.e == y.e);
+        assert(x.f >= y.f);
+
+        return Diy_fp(x.f - y.f, x.e);
+    }
+
+    // the upper 64 bits of x * y, rounded
+    //
+    static Diy_fp mul(const Diy_fp& x, const Diy_fp& y)
+    {
+        const boost::uint64_t x_low = x.f & 0xFFFFFFFF;
+        const boost::uint64_t x_high = x.f >> 32;
+        const boost::uint64_t y_low = y.f & 0xFFFFFFFF;
+        const boost::uint64_t y_high = y.f >> 32;
+
+        const boost::uint64_t low_low = x_low * y_low;
+        const boost::uint64_t low_high = x_low * y_high;
+        const boost::uint64_t high_low = x_high * y_low;
+        const boost::uint64_t high_high = x_high * y_high;
+
+        boost::uint64_t middle = (low_low >> 32) + (low_high & 0xFFFFFFFF) + (high_low & 0xFFFFFFFF);
+        middle += boost::uint64_t(1) << 31; // round
+
+        return Diy_fp(high_high + (low_high >> 32) + (high_low >> 32) + (middle >> 32), x.e + y.e + 64);
+    }
+
+    static Diy_fp normalize(Diy_fp x)
+    {
+        assert(x.f != 0);
+
+        while ((x.f >> 63) == 0)
+        {
+            x.f <<= 1;
+            --x.e;
+        }
+
+        return x;
+    }
+
+    static Diy_fp normalize_to(const Diy_fp& x, int e)
+    {
+        const int delta = x.e - e;
+
+        assert(delta >= 0);
+        assert(((x.f << delta) >> delta) == x.f);
+
+        return Diy_fp(x.f << delta, e);
+    }
+
+    boost::uint64_t f;
+    int e;
+};
+
+// a positive double and the boundaries of the interval of the reals that round to it,
+// all normalized to the same exponent
+//
+struct Boundaries
+{
+    Diy_fp w;
+    Diy_fp minus;
+    Diy_fp plus;
+};
+
+inline Boundaries compute_boundaries(double value)
+{
+    assert(value > 0 && std::isfinite(value));
+
+    const int significand_bits = 52;
+    const int exponent_bias = 1023 + significand_bits;
+    const boost::uint64_t hidden_bit = boost::uint64_t(1) << significand_bits;
+
+    boost::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    const boost::uint64_t biased_exponent = bits >> significand_bits;
+    const boost::uint64_t fraction = bits & (hidden_bit - 1);
+
+    const Diy_fp v = biased_exponent == 0
+        ? Diy_fp(fraction, 1 - exponent_bias)
+        : Diy_fp(fraction + hidden_bit, static_cast<int>(biased_exponent) - exponent_bias);
+
+    // the next smaller double is nearer when the significand is a power of two
+    const bool lower_boundary_is_closer = fraction == 0 && biased_exponent > 1;
+
+    const Diy_fp m_plus(2 * v.f + 1, v.e - 1);
+    const Diy_fp m_minus = lower_boundary_is_closer ? Diy_fp(4 * v.f - 1, v.e - 2) : Diy_fp(2 * v.f - 1, v.e - 1);
+
+    const Diy_fp w_plus = Diy_fp::normalize(m_plus);
+    const Diy_fp w_minus = Diy_fp::normalize_to(m_minus, w_plus.e);
+
+    const Boundaries boundaries = { Diy_fp::normalize(v), w_minus, w_plus };
+
+    return boundaries;
+}
+
+// the range of binary exponents of the products with a cached power, chosen so the
+// integral part of the scaled boundaries fits 32 bits
+//
+const int min_scaled_exponent = -60;
+const int max_scaled_exponent = -32;
+
+// 10^k as f * 2^e, for every 8th k
+//
+struct Cached_power
+{
+    boost::uint64_t f;
+    int e;
+    int k;
+};
+
+template<class Dummy = void>
+struct Cached_powers
+{
+    static const int min_decimal_exponent = -300;
+    static const int decimal_exponent_step = 8;
+    static const Cached_power table[79];
+};
+
+template<class Dummy>
+const Cached_power Cached_powers<Dummy>::table[79] = {
+    { 0xAB70FE17C79AC6CA, -1060, -300 },
+    { 0xFF77B1FCBEBCDC4F, -1034, -292 },
+    { 0xBE5691EF416BD60C, -1007, -284 },
+    { 0x8DD01FAD907FFC3C, -980, -276 },
+    { 0xD3515C2831559A83, -954, -268 },
+    { 0x9D71AC8FADA6C9B5, -927, -260 },
+    { 0xEA9C227723EE8BCB, -901, -252 },
+    { 0xAECC49914078536D, -874, -244 },
+    { 0x823C12795DB6CE57, -847, -236 },
+    { 0xC21094364DFB5637, -821, -228 },
+    { 0x9096EA6F3848984F, -794, -220 },
+    { 0xD77485CB25823AC7, -768, -212 },
+    { 0xA086CFCD97BF97F4, -741, -204 },
+    { 0xEF340A98172AACE5, -715, -196 },
+    { 0xB23867FB2A35B28E, -688, -188 },
+    { 0x84C8D4DFD2C63F3B, -661, -180 },
+    { 0xC5DD44271AD3CDBA, -635, -172 },
+    { 0x936B9FCEBB25C996, -608, -164 },
+    { 0xDBAC6C247D62A584, -582, -156 },
+    { 0xA3AB66580D5FDAF6, -555, -148 },
+    { 0xF3E2F893DEC3F126, -529, -140 },
+    { 0xB5B5ADA8AAFF80B8, -502, -132 },
+    { 0x87625F056C7C4A8B, -475, -124 },
+    { 0xC9BCFF6034C13053, -449, -116 },
+    { 0x964E858C91BA2655, -422, -108 },
+    { 0xDFF9772470297EBD, -396, -100 },
+    { 0xA6DFBD9FB8E5B88F, -369, -92 },
+    { 0xF8A95FCF88747D94, -343, -84 },
+    { 0xB94470938FA89BCF, -316, -76 },
+    { 0x8A08F0F8BF0F156B, -289, -68 },
+    { 0xCDB02555653131B6, -263, -60 },
+    { 0x993FE2C6D07B7FAC, -236, -52 },
+    { 0xE45C10C42A2B3B06, -210, -44 },
+    { 0xAA242499697392D3, -183, -36 },
+    { 0xFD87B5F28300CA0E, -157, -28 },
+    { 0xBCE5086492111AEB, -130, -20 },
+    { 0x8CBCCC096F5088CC, -103, -12 },
+    { 0xD1B71758E219652C, -77, -4 },
+    { 0x9C40000000000000, -50, 4 },
+    { 0xE8D4A51000000000, -24, 12 },
+    { 0xAD78EBC5AC620000, 3, 20 },
+    { 0x813F3978F8940984, 30, 28 },
+    { 0xC097CE7BC90715B3, 56, 36 },
+    { 0x8F7E32CE7BEA5C70, 83, 44 },
+    { 0xD5D238A4ABE98068, 109, 52 },
+    { 0x9F4F2726179A2245, 136, 60 },
+    { 0xED63A231D4C4FB27, 162, 68 },
+    { 0xB0DE65388CC8ADA8, 189, 76 },
+    { 0x83C7088E1AAB65DB, 216, 84 },
+    { 0xC45D1DF942711D9A, 242, 92 },
+    { 0x924D692CA61BE758, 269, 100 },
+    { 0xDA01EE641A708DEA, 295, 108 },
+    { 0xA26DA3999AEF774A, 322, 116 },
+    { 0xF209787BB47D6B85, 348, 124 },
+    { 0xB454E4A179DD1877, 375, 132 },
+    { 0x865B86925B9BC5C2, 402, 140 },
+    { 0xC83553C5C8965D3D, 428, 148 },
+    { 0x952AB45CFA97A0B3, 455, 156 },
+    { 0xDE469FBD99A05FE3, 481, 164 },
+    { 0xA59BC234DB398C25, 508, 172 },
+    { 0xF6C69A72A3989F5C, 534, 180 },
+    { 0xB7DCBF5354E9BECE, 561, 188 },
+    { 0x88FCF317F22241E2, 588, 196 },
+    { 0xCC20CE9BD35C78A5, 614, 204 },
+    { 0x98165AF37B2153DF, 641, 212 },
+    { 0xE2A0B5DC971F303A, 667, 220 },
+    { 0xA8D9D1535CE3B396, 694, 228 },
+    { 0xFB9B7CD9A4A7443C, 720, 236 },
+    { 0xBB764C4CA7A44410, 747, 244 },
+    { 0x8BAB8EEFB6409C1A, 774, 252 },
+    { 0xD01FEF10A657842C, 800, 260 },
+    { 0x9B10A4E5E9913129, 827, 268 },
+    { 0xE7109BFBA19C0C9D, 853, 276 },
+    { 0xAC2820D9623BF429, 880, 284 },
+    { 0x80444B5E7AA7CF85, 907, 292 },
+    { 0xBF21E44003ACDD2D, 933, 300 },
+    { 0x8E679C2F5E44FF8F, 960, 308 },
+    { 0xD433179D9C8CB841, 986, 316 },
+    { 0x9E19DB92B4E31BA9, 1013, 324 }
+};
+
+// the cached power c = 10^-k such that the exponent of c * 2^e lies in
+// [min_scaled_exponent, max_scaled_exponent]
+//
+inline const Cached_power& get_cached_power(int e)
+{
+    assert(e >= -1500 && e <= 1500);
+
+    const int f = min_scaled_exponent - e - 1;
+    const int k = (f * 78913) / (1 << 18) + static_cast<int>(f > 0); // ceil(f * log10(2))
+
+    const int index = (-Cached_powers<>::min_decimal_exponent + k + (Cached_powers<>::decimal_exponent_step - 1))
+        / Cached_powers<>::decimal_exponent_step;
+
+    assert(index >= 0 && index < 79);
+
+    const Cached_power& cached = Cached_powers<>::table[index];
+
+    assert(min_scaled_exponent <= cached.e + e + 64);
+    assert(max_scaled_exponent >= cached.e + e + 64);
+
+    return cached;
+}
+
+// the number of decimal digits of n, and the largest power of ten not above it
+//
+inline int find_largest_pow10(boost::uint32_t n, boost::uint32_t& pow10)
+{
+    static const boost::uint32_t powers[] = {
+        1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+    };
+
+    int digits = 1;
+
+    while (digits < 10 && n >= powers[digits])
+    {
+        ++digits;
+    }
+
+    pow10 = powers[digits - 1];
+
+    return digits;
+}
+
+// moves the last digit towards w while the result stays within the boundaries
+//
+inline void grisu2_round(char* buffer, int length, boost::uint64_t dist, boost::uint64_t delta,
+    boost::uint64_t rest, boost::uint64_t ten_k)
+{
+    assert(length >= 1);
+    assert(dist <= delta);
+    assert(rest <= delta);
+    assert(ten_k > 0);
+
+    while (rest < dist && delta - rest >= ten_k && (rest + ten_k < dist || dist - rest > rest + ten_k - dist))
+    {
+        assert(buffer[length - 1] != '0');
+
+        --buffer[length - 1];
+        rest += ten_k;
+    }
+}
+
+// generates the shortest digits of a number in [m_minus, m_plus] as close as possible to w
+//
+inline void grisu2_digit_gen(char* buffer, int& length, int& decimal_exponent,
+    const Diy_fp& m_minus, const Diy_fp& w, const Diy_fp& m_plus)
+{
+    assert(m_plus.e >= min_scaled_exponent);
+    assert(m_plus.e <= max_scaled_exponent);
+
+    boost::uint64_t delta = Diy_fp::sub(m_plus, m_minus).f;
+    boost::uint64_t dist = Diy_fp::sub(m_plus, w).f;
+
+    const Diy_fp one(boost::uint64_t(1) << -m_plus.e, m_plus.e);
+
+    boost::uint32_t p1 = static_cast<boost::uint32_t>(m_plus.f >> -one.e); // integral part
+    boost::uint64_t p2 = m_plus.f & (one.f - 1); // fractional part
+
+    assert(p1 > 0);
+
+    boost::uint32_t pow10;
+    int n = find_largest_pow10(p1, pow10);
+
+    while (n > 0)
+    {
+        const boost::uint32_t digit = p1 / pow10;
+
+        p1 %= pow10;
+        buffer[length++] = static_cast<char>('0' + digit);
+        --n;
+
+        const boost::uint64_t rest = (boost::uint64_t(p1) << -one.e) + p2;
+
+        if (rest <= delta)
+        {
+            decimal_exponent += n;
+            grisu2_round(buffer, length, dist, delta, rest, boost::uint64_t(pow10) << -one.e);
+
+            return;
+        }
+
+        pow10 /= 10;
+    }
+
+    assert(p2 > delta);
+
+    int m = 0;
+
+    for (;;)
+    {
+        p2 *= 10;
+
+        const boost::uint64_t digit = p2 >> -one.e;
+
+        p2 &= one.f - 1;
+        buffer[length++] = static_cast<char>('0' + digit);
+        ++m;
+
+        delta *= 10;
+        dist *= 10;
+
+        if (p2 <= delta)
+        {
+            break;
+        }
+    }
+
+    decimal_exponent -= m;
+    grisu2_round(buffer, length, dist, delta, p2, one.f);
+}
+
+// writes the digits of a positive double, value = digits * 10^decimal_exponent,
+// the buffer must hold 17 digits
+//
+inline int grisu2(char* buffer, int& decimal_exponent, double value)
+{
+    const Boundaries boundaries = compute_boundaries(value);
+    const Cached_power& cached = get_cached_power(boundaries.plus.e);
+    const Diy_fp c_minus_k(cached.f, cached.e);
+
+    const Diy_fp w = Diy_fp::mul(boundaries.w, c_minus_k);
+    const Diy_fp w_minus = Diy_fp::mul(boundaries.minus, c_minus_k);
+    const Diy_fp w_plus = Diy_fp::mul(boundaries.plus, c_minus_k);
+
+    // the products may be out by one, so the interval is narrowed to stay safe
+    const Diy_fp m_minus(w_minus.f + 1, w_minus.e);
+    const Diy_fp m_plus(w_plus.f - 1, w_plus.e);
+
+    int length = 0;
+    decimal_exponent = -cached.k;
+
+    grisu2_digit_gen(buffer, length, decimal_exponent, m_minus, w, m_plus);
+
+    return length;
+}
+
+// "00" to "99", so integers are written two digits at a time
+//
+template<class Dummy = void>
+struct Digit_pairs
+{
+    static const char table[201];
+};
+
+template<class Dummy>
+const char Digit_pairs<Dummy>::table[201] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+// 0 then 10^1 to 10^19, see count_digits()
+//
+template<class Dummy = void>
+struct Powers_of_ten
+{
+    static const boost::uint64_t table[20];
+};
+
+template<class Dummy>
+const boost::uint64_t Powers_of_ten<Dummy>::table[20] = {
+    0ULL,
+    10ULL,
+    100ULL,
+    1000ULL,
+    10000ULL,
+    100000ULL,
+    1000000ULL,
+    10000000ULL,
+    100000000ULL,
+    1000000000ULL,
+    10000000000ULL,
+    100000000000ULL,
+    1000000000000ULL,
+    10000000000000ULL,
+    100000000000000ULL,
+    1000000000000000ULL,
+    10000000000000000ULL,
+    100000000000000000ULL,
+    1000000000000000000ULL,
+    10000000000000000000ULL
+};
+
+// the number of decimal digits of u, estimated from its bit length as log10(2) ~ 1233 / 2^12,
+// the estimate is one too high at most
+//
+inline int count_digits(boost::uint64_t u)
+{
+    const int estimate = ((64 - number_parser::count_leading_zeros(u | 1)) * 1233) >> 12;
+
+    return estimate + 1 - static_cast<int>(u < Powers_of_ten<>::table[estimate]);
+}
+
+inline char* append_exponent(char* out, int e)
+{
+    *out++ = 'e';
+
+    if (e < 0)
+    {
+        *out++ = '-';
+        e = -e;
+    }
+    else
+    {
+        *out++ = '+';
+    }
+
+    if (e >= 100)
+    {
+        *out++ = static_cast<char>('0' + e / 100);
+        e %= 100;
+    }
+
+    *out++ = static_cast<char>('0' + e / 10);
+    *out++ = static_cast<char>('0' + e % 10);
+
+    return out;
+}
+}
+
+// the most chars format_double() writes, e.g. -2.2250738585072014e-308
+//
+const std::size_t max_double_length = 32;
+
+// the most chars format_uint64() or format_int64() write, e.g. -9223372036854775808
+//
+const std::size_t max_integer_length = 20;
+
+// writes the decimal digits of an integer, returns the end of the text
+//
+inline char* format_uint64(boost::uint64_t u, char* out)
+{
+    const char* const pairs = number_formatter::Digit_pairs<>::table;
+
+    char* const end = out + number_formatter::count_digits(u);
+    char* p = end;
+
+    while (u >= 100)
+    {
+        const std::size_t pair = static_cast<std::size_t>(u % 100) * 2;
+
+        u /= 100;
+        p -= 2;
+        p[0] = pairs[pair];
+        p[1] = pairs[pair + 1];
+    }
+
+    if (u >= 10)
+    {
+        p -= 2;
+        p[0] = pairs[u * 2];
+        p[1] = pairs[u * 2 + 1];
+    }
+    else
+    {
+        *--p = static_cast<char>('0' + u);
+    }
+
+    assert(p == out);
+
+    return end;
+}
+
+inline char* format_int64(boost::int64_t i, char* out)
+{
+    if (i < 0)
+    {
+        *out++ = '-';
+
+        return format_uint64(0 - static_cast<boost::uint64_t>(i), out);
+    }
+
+    return format_uint64(static_cast<boost::uint64_t>(i), out);
+}
+
+// writes a double as JSON text, returns the end of the text
+//
+// Numbers from 1e-4 up to 1e17 are written in fixed notation and the others in
+// scientific notation. Either way there is a decimal point with at least one digit
+// after it, so the number reads back as a double, e.g. 0.0, 100.0, 0.001, 1.0e-10
+// and 1.23e+67. Infinities and NaNs, which JSON cannot represent, are written as
+// inf, -inf and nan.
+//
+inline char* format_double(double value, char* out)
+{
+    if (std::signbit(value))
+    {
+        *out++ = '-';
+        value = -value;
+    }
+
+    if (!std::isfinite(value))
+    {
+        const char* const text = std::isnan(value) ? "nan" : "inf";
+
+        std::memcpy(out, text, 3);
+
+        return out + 3;
+    }
+
+    if (value == 0)
+    {
+        std::memcpy(out, "0.0", 3);
+
+        return out + 3;
+    }
+
+    char digits[17];
+    int decimal_exponent;
+    const int length = number_formatter::grisu2(digits, decimal_exponent, value);
+
+    const int exponent = length + decimal_exponent - 1; // of the first digit
+
+    if (exponent < -4 || exponent >= 17)
+    {
+        *out++ = digits[0];
+        *out++ = '.';
+
+        if (length == 1)
+        {
+            *out++ = '0';
+        }
+        else
+        {
+            std::memcpy(out, digits + 1, length - 1);
+            out += length - 1;
+        }
+
+        return number_formatter::append_exponent(out, exponent);
+    }
+
+    if (exponent < 0)
+    {
+        *out++ = '0';
+        *out++ = '.';
+
+        for (int i = exponent + 1; i < 0; ++i)
+        {
+            *out++ = '0';
+        }
+
+        std::memcpy(out, digits, length);
+
+        return out + length;
+    }
+
+    const int integral_length = exponent + 1;
+
+    if (length <= integral_length)
+    {
+        std::memcpy(out, digits, length);
+        out += length;
+
+        for (int i = length; i < integral_length; ++i)
+        {
+            *out++ = '0';
+        }
+
+        *out++ = '.';
+        *out++ = '0';
+
+        return out;
+    }
+
+    std::memcpy(out, digits, integral_length);
+    out += integral_length;
+    *out++ = '.';
+    std::memcpy(out, digits + integral_length, length - integral_length);
+
+    return out + length - integral_length;
+}
+}
+
+#endif
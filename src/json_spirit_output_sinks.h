@@ -0,0 +1,293 @@
+#ifndef JSON_SPIRIT_OUTPUT_SINKS
+#define JSON_SPIRIT_OUTPUT_SINKS
+
+//          Copyright John W. Wilkinson 2007 - 2014
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+
+// json spirit version 4.08
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+// The sinks that the generator writes JSON text to, see write_to_sink() in
+// json_spirit_writer_template.h.
+//
+// A sink is any class with a Char_type typedef and these two members:
+//
+// void put( Char_type c );
+// void write( const Char_type* s, std::size_t n );
+//
+// They are called for every token, so they should do little more than copy characters.
+
+namespace json_spirit
+{
+// appends the text to a container owned by the caller, e.g. a std::string or a
+// std::vector< char > reused for one response after another, e.g.
+//
+// std::string text;
+// Append_sink< std::string > sink( text );
+// write_to_sink( value, sink );
+//
+template<class Container>
+class Append_sink
+{
+public:
+    typedef typename Container::value_type Char_type;
+
+    explicit Append_sink(Container& container)
+        : container_(container)
+    {
+    }
+
+    void put(Char_type c)
+    {
+        container_.push_back(c);
+    }
+
+    void write(const Char_type* s, std::size_t n)
+    {
+        container_.insert(container_.end(), s, s + n);
+    }
+
+private:
+    Append_sink& operator=(const Append_sink&);
+
+    Container& container_;
+};
+
+// writes the text to a buffer of fixed capacity, the text does not get a terminating null
+//
+// The text that does not fit is dropped but still counted, so after an overflow the
+// caller can get a large enough buffer and write again, e.g.
+//
+// Buffer_sink< char > sink( buffer, sizeof( buffer ) );
+// write_to_sink( value, sink );
+// if( sink.overflowed() ) ... sink.required_size() ...
+//
+template<class Char_type_>
+class Buffer_sink
+{
+public:
+    typedef Char_type_ Char_type;
+
+    Buffer_sink(Char_type* buffer, std::size_t capacity)
+        : buffer_(buffer)
+        , capacity_(capacity)
+        , required_size_(0)
+    {
+    }
+
+    void put(Char_type c)
+    {
+        if (required_size_ < capacity_)
+        {
+            buffer_[required_size_] = c;
+        }
+
+        ++required_size_;
+    }
+
+    void write(const Char_type* s, std::size_t n)
+    {
+        if (required_size_ < capacity_)
+        {
+            std::copy(s, s + std::min(n, capacity_ - required_size_), buffer_ + required_size_);
+        }
+
+        required_size_ += n;
+    }
+
+    // the number of characters in the buffer
+    //
+    std::size_t size() const
+    {
+        return std::min(required_size_, capacity_);
+    }
+
+    // the number of characters of the whole text
+    //
+    std::size_t required_size() const
+    {
+        return required_size_;
+    }
+
+    bool overflowed() const
+    {
+        return required_size_ > capacity_;
+    }
+
+private:
+    Char_type* buffer_;
+    std::size_t capacity_;
+    std::size_t required_size_;
+};
+
+// writes the text to a file descriptor, e.g. a socket or a pipe, through a buffer so that
+// there is one system call per buffer rather than per token
+//
+// The buffer is flushed when full and on destruction, call flush() to find out whether
+// everything was written. After an error nothing more is written and error() returns the
+// errno of the failed write.
+//
+class Fd_sink
+{
+public:
+    typedef char Char_type;
+
+    static const std::size_t default_buffer_size = 64 * 1024;
+
+    explicit Fd_sink(int fd, std::size_t buffer_size = default_buffer_size)
+        : fd_(fd)
+        , buffer_(std::max<std::size_t>(buffer_size, 1))
+        , size_(0)
+        , error_(0)
+    {
+    }
+
+    ~Fd_sink()
+    {
+        flush();
+    }
+
+    void put(char c)
+    {
+        if (size_ == buffer_.size())
+        {
+            flush();
+        }
+
+        buffer_[size_++] = c;
+    }
+
+    void write(const char* s, std::size_t n)
+    {
+        if (n > buffer_.size() - size_)
+        {
+            flush();
+
+            if (n >= buffer_.size())
+            {
+                write_fd(s, n);
+
+                return;
+            }
+        }
+
+        std::copy(s, s + n, buffer_.data() + size_);
+        size_ += n;
+    }
+
+    // returns false if any of the text could not be written
+    //
+    bool flush()
+    {
+        write_fd(buffer_.data(), size_);
+        size_ = 0;
+
+        return error_ == 0;
+    }
+
+    int error() const
+    {
+        return error_;
+    }
+
+private:
+    Fd_sink(const Fd_sink&);
+    Fd_sink& operator=(const Fd_sink&);
+
+    void write_fd(const char* s, std::size_t n)
+    {
+        while (n != 0 && error_ == 0)
+        {
+#ifdef _WIN32
+            const int written = ::_write(fd_, s, static_cast<unsigned int>(std::min<std::size_t>(n, 0x40000000)));
+#else
+            const ssize_t written = ::write(fd_, s, n);
+#endif
+            if (written < 0)
+            {
+                if (errno != EINTR)
+                {
+                    error_ = errno;
+                }
+            }
+            else
+            {
+                s += written;
+                n -= static_cast<std::size_t>(written);
+            }
+        }
+    }
+
+    int fd_;
+    std::vector<char> buffer_;
+    std::size_t size_;
+    int error_;
+};
+
+// writes the text to a stream's buffer, checking the stream once rather than for every
+// token as the stream's own operators would
+//
+// The stream gets the badbit when its buffer does not take all of the text.
+//
+template<class Ostream_type>
+class Ostream_sink
+{
+public:
+    typedef typename Ostream_type::char_type Char_type;
+
+    explicit Ostream_sink(Ostream_type& os)
+        : os_(os)
+        , sentry_(os)
+        , buf_(sentry_ ? os.rdbuf() : nullptr)
+    {
+    }
+
+    void put(Char_type c)
+    {
+        if (buf_ != nullptr && Ostream_type::traits_type::eq_int_type(buf_->sputc(c), Ostream_type::traits_type::eof()))
+        {
+            fail();
+        }
+    }
+
+    void write(const Char_type* s, std::size_t n)
+    {
+        if (buf_ != nullptr && buf_->sputn(s, static_cast<std::streamsize>(n)) != static_cast<std::streamsize>(n))
+        {
+            fail();
+        }
+    }
+
+private:
+    Ostream_sink(const Ostream_sink&);
+    Ostream_sink& operator=(const Ostream_sink&);
+
+    void fail()
+    {
+        buf_ = nullptr;
+        os_.setstate(std::ios_base::badbit);
+    }
+
+    Ostream_type& os_;
+    typename Ostream_type::sentry sentry_;
+    std::basic_streambuf<Char_type, typename Ostream_type::traits_type>* buf_;
+};
+}
+
+#endif
@@ -38,6 +38,46 @@ void json_spirit::read_or_throw(std::string::const_iterator& begin, std::string:
 {
     begin = read_range_or_throw(begin, end, value, false);
 }
+
+bool json_spirit::read(const char* s, Value& value)
+{
+    return read_chars(s, s + std::char_traits<char>::length(s), value);
+}
+
+void json_spirit::read_or_throw(const char* s, Value& value)
+{
+    read_chars_or_throw(s, s + std::char_traits<char>::length(s), value);
+}
+
+bool json_spirit::read(const char* s, std::size_t length, Value& value)
+{
+    return read_chars(s, s + length, value);
+}
+
+void json_spirit::read_or_throw(const char* s, std::size_t length, Value& value)
+{
+    read_chars_or_throw(s, s + length, value);
+}
+
+bool json_spirit::read(boost::string_ref s, Value& value)
+{
+    return read_chars(s.data(), s.data() + s.size(), value);
+}
+
+void json_spirit::read_or_throw(boost::string_ref s, Value& value)
+{
+    read_chars_or_throw(s.data(), s.data() + s.size(), value);
+}
+
+bool json_spirit::read_in_situ(char* s, std::size_t length, vValue& value)
+{
+    return read_in_situ(s, s + length, value);
+}
+
+void json_spirit::read_in_situ_or_throw(char* s, std::size_t length, vValue& value)
+{
+    read_in_situ_or_throw(s, s + length, value);
+}
 #endif
 
 #if defined(JSON_SPIRIT_WVALUE_ENABLED) && !defined(BOOST_NO_STD_WSTRING)
@@ -70,6 +110,46 @@ void json_spirit::read_or_throw(std::wstring::const_iterator& begin, std::wstrin
 {
     begin = read_range_or_throw(begin, end, value, false);
 }
+
+bool json_spirit::read(const wchar_t* s, wValue& value)
+{
+    return read_chars(s, s + std::char_traits<wchar_t>::length(s), value);
+}
+
+void json_spirit::read_or_throw(const wchar_t* s, wValue& value)
+{
+    read_chars_or_throw(s, s + std::char_traits<wchar_t>::length(s), value);
+}
+
+bool json_spirit::read(const wchar_t* s, std::size_t length, wValue& value)
+{
+    return read_chars(s, s + length, value);
+}
+
+void json_spirit::read_or_throw(const wchar_t* s, std::size_t length, wValue& value)
+{
+    read_chars_or_throw(s, s + length, value);
+}
+
+bool json_spirit::read(boost::wstring_ref s, wValue& value)
+{
+    return read_chars(s.data(), s.data() + s.size(), value);
+}
+
+void json_spirit::read_or_throw(boost::wstring_ref s, wValue& value)
+{
+    read_chars_or_throw(s.data(), s.data() + s.size(), value);
+}
+
+bool json_spirit::read_in_situ(wchar_t* s, std::size_t length, wvValue& value)
+{
+    return read_in_situ(s, s + length, value);
+}
+
+void json_spirit::read_in_situ_or_throw(wchar_t* s, std::size_t length, wvValue& value)
+{
+    read_in_situ_or_throw(s, s + length, value);
+}
 #endif
 
 #ifdef JSON_SPIRIT_MVALUE_ENABLED
@@ -102,6 +182,36 @@ void json_spirit::read_or_throw(std::string::const_iterator& begin, std::string:
 {
     begin = read_range_or_throw(begin, end, value, false);
 }
+
+bool json_spirit::read(const char* s, mValue& value)
+{
+    return read_chars(s, s + std::char_traits<char>::length(s), value);
+}
+
+void json_spirit::read_or_throw(const char* s, mValue& value)
+{
+    read_chars_or_throw(s, s + std::char_traits<char>::length(s), value);
+}
+
+bool json_spirit::read(const char* s, std::size_t length, mValue& value)
+{
+    return read_chars(s, s + length, value);
+}
+
+void json_spirit::read_or_throw(const char* s, std::size_t length, mValue& value)
+{
+    read_chars_or_throw(s, s + length, value);
+}
+
+bool json_spirit::read(boost::string_ref s, mValue& value)
+{
+    return read_chars(s.data(), s.data() + s.size(), value);
+}
+
+void json_spirit::read_or_throw(boost::string_ref s, mValue& value)
+{
+    read_chars_or_throw(s.data(), s.data() + s.size(), value);
+}
 #endif
 
 #if defined(JSON_SPIRIT_WMVALUE_ENABLED) && !defined(BOOST_NO_STD_WSTRING)
@@ -134,4 +244,158 @@ void json_spirit::read_or_throw(std::wstring::const_iterator& begin, std::wstrin
 {
     begin = read_range_or_throw(begin, end, value, false);
 }
+
+bool json_spirit::read(const wchar_t* s, wmValue& value)
+{
+    return read_chars(s, s + std::char_traits<wchar_t>::length(s), value);
+}
+
+void json_spirit::read_or_throw(const wchar_t* s, wmValue& value)
+{
+    read_chars_or_throw(s, s + std::char_traits<wchar_t>::length(s), value);
+}
+
+bool json_spirit::read(const wchar_t* s, std::size_t length, wmValue& value)
+{
+    return read_chars(s, s + length, value);
+}
+
+void json_spirit::read_or_throw(const wchar_t* s, std::size_t length, wmValue& value)
+{
+    read_chars_or_throw(s, s + length, value);
+}
+
+bool json_spirit::read(boost::wstring_ref s, wmValue& value)
+{
+    return read_chars(s.data(), s.data() + s.size(), value);
+}
+
+void json_spirit::read_or_throw(boost::wstring_ref s, wmValue& value)
+{
+    read_chars_or_throw(s.data(), s.data() + s.size(), value);
+}
+#endif
+
+#ifdef JSON_SPIRIT_HVALUE_ENABLED
+bool json_spirit::read(const std::string& s, hValue& value)
+{
+    return read_string(s, value);
+}
+
+void json_spirit::read_or_throw(const std::string& s, hValue& value)
+{
+    read_string_or_throw(s, value);
+}
+
+bool json_spirit::read(std::istream& is, hValue& value)
+{
+    return read_stream(is, value);
+}
+
+void json_spirit::read_or_throw(std::istream& is, hValue& value)
+{
+    read_stream_or_throw(is, value);
+}
+
+bool json_spirit::read(std::string::const_iterator& begin, std::string::const_iterator end, hValue& value)
+{
+    return read_range(begin, end, value, false);
+}
+
+void json_spirit::read_or_throw(std::string::const_iterator& begin, std::string::const_iterator end, hValue& value)
+{
+    begin = read_range_or_throw(begin, end, value, false);
+}
+
+bool json_spirit::read(const char* s, hValue& value)
+{
+    return read_chars(s, s + std::char_traits<char>::length(s), value);
+}
+
+void json_spirit::read_or_throw(const char* s, hValue& value)
+{
+    read_chars_or_throw(s, s + std::char_traits<char>::length(s), value);
+}
+
+bool json_spirit::read(const char* s, std::size_t length, hValue& value)
+{
+    return read_chars(s, s + length, value);
+}
+
+void json_spirit::read_or_throw(const char* s, std::size_t length, hValue& value)
+{
+    read_chars_or_throw(s, s + length, value);
+}
+
+bool json_spirit::read(boost::string_ref s, hValue& value)
+{
+    return read_chars(s.data(), s.data() + s.size(), value);
+}
+
+void json_spirit::read_or_throw(boost::string_ref s, hValue& value)
+{
+    read_chars_or_throw(s.data(), s.data() + s.size(), value);
+}
+#endif
+
+#if defined(JSON_SPIRIT_WHVALUE_ENABLED) && !defined(BOOST_NO_STD_WSTRING)
+bool json_spirit::read(const std::wstring& s, whValue& value)
+{
+    return read_string(s, value);
+}
+
+void json_spirit::read_or_throw(const std::wstring& s, whValue& value)
+{
+    read_string_or_throw(s, value);
+}
+
+bool json_spirit::read(std::wistream& is, whValue& value)
+{
+    return read_stream(is, value);
+}
+
+void json_spirit::read_or_throw(std::wistream& is, whValue& value)
+{
+    read_stream_or_throw(is, value);
+}
+
+bool json_spirit::read(std::wstring::const_iterator& begin, std::wstring::const_iterator end, whValue& value)
+{
+    return read_range(begin, end, value, false);
+}
+
+void json_spirit::read_or_throw(std::wstring::const_iterator& begin, std::wstring::const_iterator end, whValue& value)
+{
+    begin = read_range_or_throw(begin, end, value, false);
+}
+
+bool json_spirit::read(const wchar_t* s, whValue& value)
+{
+    return read_chars(s, s + std::char_traits<wchar_t>::length(s), value);
+}
+
+void json_spirit::read_or_throw(const wchar_t* s, whValue& value)
+{
+    read_chars_or_throw(s, s + std::char_traits<wchar_t>::length(s), value);
+}
+
+bool json_spirit::read(const wchar_t* s, std::size_t length, whValue& value)
+{
+    return read_chars(s, s + length, value);
+}
+
+void json_spirit::read_or_throw(const wchar_t* s, std::size_t length, whValue& value)
+{
+    read_chars_or_throw(s, s + length, value);
+}
+
+bool json_spirit::read(boost::wstring_ref s, whValue& value)
+{
+    return read_chars(s.data(), s.data() + s.size(), value);
+}
+
+void json_spirit::read_or_throw(boost::wstring_ref s, whValue& value)
+{
+    read_chars_or_throw(s.data(), s.data() + s.size(), value);
+}
 #endif
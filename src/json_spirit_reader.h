@@ -12,50 +12,204 @@
 
 #include "json_spirit_error_position.h"
 #include "json_spirit_value.h"
+#include <boost/utility/string_ref.hpp>
+#include <cstddef>
 #include <iostream>
 
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+#include <string_view>
+#define JSON_SPIRIT_STD_STRING_VIEW
+#endif
+
 namespace json_spirit
 {
 // functions to reads a JSON values
 
+// The character pointer and string_ref overloads read the text where it is without
+// copying it, e.g. straight from a network buffer. A pointer without a length must
+// point to a null terminated string.
+
+// The read_in_situ functions do not copy the strings either, the strings and names
+// of the vValue or wvValue read are views of the buffer, which must outlive the
+// value. The buffer is changed by replacing escape sequences in place, unless the
+// text is invalid.
+
 #ifdef JSON_SPIRIT_VALUE_ENABLED
 bool read(const std::string& s, Value& value);
 bool read(std::istream& is, Value& value);
 bool read(std::string::const_iterator& begin, std::string::const_iterator end, Value& value);
+bool read(const char* s, Value& value);
+bool read(const char* s, std::size_t length, Value& value);
+bool read(boost::string_ref s, Value& value);
 
 void read_or_throw(const std::string& s, Value& value);
 void read_or_throw(std::istream& is, Value& value);
 void read_or_throw(std::string::const_iterator& begin, std::string::const_iterator end, Value& value);
+void read_or_throw(const char* s, Value& value);
+void read_or_throw(const char* s, std::size_t length, Value& value);
+void read_or_throw(boost::string_ref s, Value& value);
+
+bool read_in_situ(char* s, std::size_t length, vValue& value);
+void read_in_situ_or_throw(char* s, std::size_t length, vValue& value);
 #endif
 
 #if defined(JSON_SPIRIT_WVALUE_ENABLED) && !defined(BOOST_NO_STD_WSTRING)
 bool read(const std::wstring& s, wValue& value);
 bool read(std::wistream& is, wValue& value);
 bool read(std::wstring::const_iterator& begin, std::wstring::const_iterator end, wValue& value);
+bool read(const wchar_t* s, wValue& value);
+bool read(const wchar_t* s, std::size_t length, wValue& value);
+bool read(boost::wstring_ref s, wValue& value);
 
 void read_or_throw(const std::wstring& s, wValue& value);
 void read_or_throw(std::wistream& is, wValue& value);
 void read_or_throw(std::wstring::const_iterator& begin, std::wstring::const_iterator end, wValue& value);
+void read_or_throw(const wchar_t* s, wValue& value);
+void read_or_throw(const wchar_t* s, std::size_t length, wValue& value);
+void read_or_throw(boost::wstring_ref s, wValue& value);
+
+bool read_in_situ(wchar_t* s, std::size_t length, wvValue& value);
+void read_in_situ_or_throw(wchar_t* s, std::size_t length, wvValue& value);
 #endif
 
 #ifdef JSON_SPIRIT_MVALUE_ENABLED
 bool read(const std::string& s, mValue& value);
 bool read(std::istream& is, mValue& value);
 bool read(std::string::const_iterator& begin, std::string::const_iterator end, mValue& value);
+bool read(const char* s, mValue& value);
+bool read(const char* s, std::size_t length, mValue& value);
+bool read(boost::string_ref s, mValue& value);
 
 void read_or_throw(const std::string& s, mValue& value);
 void read_or_throw(std::istream& is, mValue& value);
 void read_or_throw(std::string::const_iterator& begin, std::string::const_iterator end, mValue& value);
+void read_or_throw(const char* s, mValue& value);
+void read_or_throw(const char* s, std::size_t length, mValue& value);
+void read_or_throw(boost::string_ref s, mValue& value);
 #endif
 
 #if defined(JSON_SPIRIT_WMVALUE_ENABLED) && !defined(BOOST_NO_STD_WSTRING)
 bool read(const std::wstring& s, wmValue& value);
 bool read(std::wistream& is, wmValue& value);
 bool read(std::wstring::const_iterator& begin, std::wstring::const_iterator end, wmValue& value);
+bool read(const wchar_t* s, wmValue& value);
+bool read(const wchar_t* s, std::size_t length, wmValue& value);
+bool read(boost::wstring_ref s, wmValue& value);
 
 void read_or_throw(const std::wstring& s, wmValue& value);
 void read_or_throw(std::wistream& is, wmValue& value);
 void read_or_throw(std::wstring::const_iterator& begin, std::wstring::const_iterator end, wmValue& value);
+void read_or_throw(const wchar_t* s, wmValue& value);
+void read_or_throw(const wchar_t* s, std::size_t length, wmValue& value);
+void read_or_throw(boost::wstring_ref s, wmValue& value);
+#endif
+
+#ifdef JSON_SPIRIT_HVALUE_ENABLED
+bool read(const std::string& s, hValue& value);
+bool read(std::istream& is, hValue& value);
+bool read(std::string::const_iterator& begin, std::string::const_iterator end, hValue& value);
+bool read(const char* s, hValue& value);
+bool read(const char* s, std::size_t length, hValue& value);
+bool read(boost::string_ref s, hValue& value);
+
+void read_or_throw(const std::string& s, hValue& value);
+void read_or_throw(std::istream& is, hValue& value);
+void read_or_throw(std::string::const_iterator& begin, std::string::const_iterator end, hValue& value);
+void read_or_throw(const char* s, hValue& value);
+void read_or_throw(const char* s, std::size_t length, hValue& value);
+void read_or_throw(boost::string_ref s, hValue& value);
+#endif
+
+#if defined(JSON_SPIRIT_WHVALUE_ENABLED) && !defined(BOOST_NO_STD_WSTRING)
+bool read(const std::wstring& s, whValue& value);
+bool read(std::wistream& is, whValue& value);
+bool read(std::wstring::const_iterator& begin, std::wstring::const_iterator end, whValue& value);
+bool read(const wchar_t* s, whValue& value);
+bool read(const wchar_t* s, std::size_t length, whValue& value);
+bool read(boost::wstring_ref s, whValue& value);
+
+void read_or_throw(const std::wstring& s, whValue& value);
+void read_or_throw(std::wistream& is, whValue& value);
+void read_or_throw(std::wstring::const_iterator& begin, std::wstring::const_iterator end, whValue& value);
+void read_or_throw(const wchar_t* s, whValue& value);
+void read_or_throw(const wchar_t* s, std::size_t length, whValue& value);
+void read_or_throw(boost::wstring_ref s, whValue& value);
+#endif
+
+#ifdef JSON_SPIRIT_STD_STRING_VIEW
+// for C++17 callers, forward to the pointer and length overloads
+
+#ifdef JSON_SPIRIT_VALUE_ENABLED
+inline bool read(std::string_view s, Value& value)
+{
+    return read(s.data(), s.size(), value);
+}
+
+inline void read_or_throw(std::string_view s, Value& value)
+{
+    read_or_throw(s.data(), s.size(), value);
+}
+#endif
+
+#if defined(JSON_SPIRIT_WVALUE_ENABLED) && !defined(BOOST_NO_STD_WSTRING)
+inline bool read(std::wstring_view s, wValue& value)
+{
+    return read(s.data(), s.size(), value);
+}
+
+inline void read_or_throw(std::wstring_view s, wValue& value)
+{
+    read_or_throw(s.data(), s.size(), value);
+}
+#endif
+
+#ifdef JSON_SPIRIT_MVALUE_ENABLED
+inline bool read(std::string_view s, mValue& value)
+{
+    return read(s.data(), s.size(), value);
+}
+
+inline void read_or_throw(std::string_view s, mValue& value)
+{
+    read_or_throw(s.data(), s.size(), value);
+}
+#endif
+
+#if defined(JSON_SPIRIT_WMVALUE_ENABLED) && !defined(BOOST_NO_STD_WSTRING)
+inline bool read(std::wstring_view s, wmValue& value)
+{
+    return read(s.data(), s.size(), value);
+}
+
+inline void read_or_throw(std::wstring_view s, wmValue& value)
+{
+    read_or_throw(s.data(), s.size(), value);
+}
+#endif
+
+#ifdef JSON_SPIRIT_HVALUE_ENABLED
+inline bool read(std::string_view s, hValue& value)
+{
+    return read(s.data(), s.size(), value);
+}
+
+inline void read_or_throw(std::string_view s, hValue& value)
+{
+    read_or_throw(s.data(), s.size(), value);
+}
+#endif
+
+#if defined(JSON_SPIRIT_WHVALUE_ENABLED) && !defined(BOOST_NO_STD_WSTRING)
+inline bool read(std::wstring_view s, whValue& value)
+{
+    return read(s.data(), s.size(), value);
+}
+
+inline void read_or_throw(std::wstring_view s, whValue& value)
+{
+    read_or_throw(s.data(), s.size(), value);
+}
+#endif
 #endif
 }
 
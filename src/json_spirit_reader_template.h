@@ -11,13 +11,19 @@
 #endif
 
 #include "json_spirit_error_position.h"
+#include "json_spirit_number_parser.h"
+#include "json_spirit_simd.h"
 #include "json_spirit_value.h"
 
 //#define BOOST_SPIRIT_THREADSAFE  // uncomment for multithreaded use, requires linking to boost.thread
 
-#include <boost/bind.hpp>
-#include <boost/function.hpp>
 #include <boost/version.hpp>
+#include <algorithm>
+#include <cwctype>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <utility>
 
 #if BOOST_VERSION >= 103800
 #include <boost/spirit/include/classic_confix.hpp>
@@ -38,98 +44,59 @@
 namespace json_spirit
 {
 
-// Does not allow `+[0..9]` numbers - leading `+` is not allowed for JSON.
-template<
-    typename T = unsigned,
-    int Radix = 10,
-    unsigned MinDigits = 1,
-    int MaxDigits = -1>
-struct json_int_parser_impl
-    : spirit_namespace::parser<json_int_parser_impl<T, Radix, MinDigits, MaxDigits>>
+// Matches a number in one pass with scan_json_number(), the attribute is a
+// Json_number saying whether it is a double, an int64 or an uint64.
+struct json_number_parser_impl : spirit_namespace::parser<json_number_parser_impl>
 {
-    typedef json_int_parser_impl<T, Radix, MinDigits, MaxDigits> self_t;
+    typedef json_number_parser_impl self_t;
 
     template<typename ScannerT>
     struct result
     {
-        typedef typename spirit_namespace::match_result<ScannerT, T>::type type;
+        typedef typename spirit_namespace::match_result<ScannerT, Json_number>::type type;
     };
 
     template<typename ScannerT>
     typename spirit_namespace::parser_result<self_t, ScannerT>::type
     parse(ScannerT const& scan) const
     {
-        using namespace spirit_namespace;
-
-        typedef spirit_namespace::impl::extract_int<Radix, MinDigits, MaxDigits,
-            spirit_namespace::impl::negative_accumulate<T, Radix>>
-            extract_int_neg_t;
-        typedef spirit_namespace::impl::extract_int<Radix, MinDigits, MaxDigits,
-            spirit_namespace::impl::positive_accumulate<T, Radix>>
-            extract_int_pos_t;
-
         if (!scan.at_end())
         {
-            T n = 0;
-            std::size_t count = 0;
             typename ScannerT::iterator_t save = scan.first;
 
-            bool hit = false;
-            if (*scan == '-')
-            {
-                ++scan;
-                ++count;
-                hit = extract_int_neg_t::f(scan, n, count);
-            }
-            else
+            Json_number number;
+            scan.first = scan_json_number(save, scan.last, number);
+
+            if (number.kind != not_a_number)
             {
-                hit = extract_int_pos_t::f(scan, n, count);
+                const std::size_t count = std::distance(save, scan.first);
+                return scan.create_match(count, number, save, scan.first);
             }
-
-            if (hit)
-                return scan.create_match(count, n, save, scan.first);
-            else
-                scan.first = save;
-            // return no-match if number overflows or underflows
         }
         return scan.no_match();
     }
 };
 
-template<
-    typename T,
-    int Radix,
-    unsigned MinDigits,
-    int MaxDigits>
-struct json_int_parser : spirit_namespace::parser<json_int_parser<T, Radix, MinDigits, MaxDigits>>
+struct json_number_parser : spirit_namespace::parser<json_number_parser>
 {
-    typedef json_int_parser<T, Radix, MinDigits, MaxDigits> self_t;
+    typedef json_number_parser self_t;
 
     template<typename ScannerT>
     struct result
     {
-        typedef typename spirit_namespace::match_result<ScannerT, T>::type type;
+        typedef typename spirit_namespace::match_result<ScannerT, Json_number>::type type;
     };
 
     template<typename ScannerT>
     typename spirit_namespace::parser_result<self_t, ScannerT>::type
     parse(ScannerT const& scan) const
     {
-        typedef json_int_parser_impl<T, Radix, MinDigits, MaxDigits> impl_t;
-        typedef typename spirit_namespace::parser_result<impl_t, ScannerT>::type result_t;
-        return spirit_namespace::impl::contiguous_parser_parse<result_t>(impl_t(), scan, scan);
+        typedef typename spirit_namespace::parser_result<json_number_parser_impl, ScannerT>::type result_t;
+        return spirit_namespace::impl::contiguous_parser_parse<result_t>(json_number_parser_impl(), scan, scan);
     }
 };
 
-template<typename T>
-struct json_real_parser_policies : public spirit_namespace::strict_real_parser_policies<T>
-{
-    BOOST_STATIC_CONSTANT(bool, allow_trailing_dot = false);
-};
-
-const json_int_parser<boost::int64_t, 10, 1, -1> int64_p{};
-const spirit_namespace::uint_parser<boost::uint64_t> uint64_p{};
-const spirit_namespace::real_parser<double, json_real_parser_policies<double>> json_real_p{};
+const json_number_parser json_number_p{};
 
 template<typename Iter_type>
 void throw_error(spirit_namespace::position_iterator<Iter_type> i, const std::string& reason)
@@ -194,10 +161,8 @@ Char_type unicode_str_to_char(Iter_type& begin)
         + hex_to_num(c4);
 }
 
-template<class String_type>
-void append_esc_char_and_incr_iter(String_type& s,
-    typename String_type::const_iterator& begin,
-    typename String_type::const_iterator end)
+template<class String_type, class Iter_type>
+void append_esc_char_and_incr_iter(String_type& s, Iter_type& begin, Iter_type end)
 {
     typedef typename String_type::value_type Char_type;
 
@@ -248,59 +213,132 @@ void append_esc_char_and_incr_iter(String_type& s,
     }
 }
 
-template<class String_type>
-String_type substitute_esc_chars(typename String_type::const_iterator begin,
-    typename String_type::const_iterator end)
+// returns the first '\\' or '\n' in [begin, end), or 'end'
+//
+template<class Iter_type>
+Iter_type find_esc_or_newline(Iter_type begin, Iter_type end)
+{
+    for (; begin != end; ++begin)
+    {
+        if (*begin == '\\' || *begin == '\n')
+        {
+            break;
+        }
+    }
+    return begin;
+}
+
+inline const char* find_esc_or_newline(const char* begin, const char* end)
+{
+    return simd::find_either(begin, end, '\\', '\n');
+}
+
+inline std::string::const_iterator find_esc_or_newline(std::string::const_iterator begin, std::string::const_iterator end)
 {
-    using Iter_type = typename String_type::const_iterator;
+    const char* const first = &*begin;
 
+    return begin + (find_esc_or_newline(first, first + (end - begin)) - first);
+}
+
+template<class String_type, class Iter_type>
+String_type substitute_esc_chars(Iter_type begin, Iter_type end,
+    const typename String_type::allocator_type& allocator = typename String_type::allocator_type())
+{
     if (end - begin < 2)
     {
-        return String_type(begin, end);
+        return (begin == end) ? String_type(allocator) : String_type(1, *begin, allocator);
     }
 
-    String_type result;
+    String_type result(allocator);
     result.reserve(static_cast<size_t>(end - begin));
 
+    // the last character is not checked, it can't start an escape sequence
     const Iter_type end_minus_1(end - 1);
     Iter_type substr_start = begin;
     Iter_type i = begin;
-    for (; i < end_minus_1; ++i)
+    while (i < end_minus_1)
     {
+        i = find_esc_or_newline(i, end_minus_1);
+
+        if (i == end_minus_1)
+        {
+            break;
+        }
         if (*i == '\n')
         {
             throw_error(i, "unescaped newline in string");
         }
-        if (*i == '\\')
-        {
-            result.append(substr_start, i);
 
-            ++i; // skip the '\'
+        result.append(substr_start, i);
 
-            append_esc_char_and_incr_iter(result, i, end);
+        ++i; // skip the '\\'
 
-            substr_start = i + 1;
-        }
+        append_esc_char_and_incr_iter(result, i, end);
+
+        substr_start = ++i;
     }
     result.append(substr_start, end);
 
     return result;
 }
 
-template<class String_type>
-String_type get_str_(typename String_type::const_iterator begin,
-    typename String_type::const_iterator end)
+template<class String_type, class Iter_type>
+String_type get_str_(Iter_type begin, Iter_type end,
+    const typename String_type::allocator_type& allocator = typename String_type::allocator_type())
 {
     assert(end - begin >= 2);
 
-    typedef typename String_type::const_iterator Iter_type;
-
     Iter_type str_without_quotes(++begin);
     Iter_type end_without_quotes(--end);
 
-    return substitute_esc_chars<String_type>(str_without_quotes, end_without_quotes);
+    return substitute_esc_chars<String_type>(str_without_quotes, end_without_quotes, allocator);
 }
 
+// true for iterators over a contiguous block of characters, i.e. pointers and
+// string iterators; such input can be scanned without copying and without Spirit
+//
+template<class Iter_type>
+struct Is_contiguous_iter : std::false_type
+{
+};
+
+template<class Char_type>
+struct Is_contiguous_iter<Char_type*> : std::true_type
+{
+};
+
+template<>
+struct Is_contiguous_iter<std::string::iterator> : std::true_type
+{
+};
+
+template<>
+struct Is_contiguous_iter<std::string::const_iterator> : std::true_type
+{
+};
+
+template<>
+struct Is_contiguous_iter<std::vector<char>::iterator> : std::true_type
+{
+};
+
+template<>
+struct Is_contiguous_iter<std::vector<char>::const_iterator> : std::true_type
+{
+};
+
+#ifndef BOOST_NO_STD_WSTRING
+template<>
+struct Is_contiguous_iter<std::wstring::iterator> : std::true_type
+{
+};
+
+template<>
+struct Is_contiguous_iter<std::wstring::const_iterator> : std::true_type
+{
+};
+#endif
+
 inline std::string get_str(std::string::const_iterator begin, std::string::const_iterator end)
 {
     return get_str_<std::string>(begin, end);
@@ -312,13 +350,118 @@ inline std::wstring get_str(std::wstring::const_iterator begin, std::wstring::co
 }
 
 template<class String_type, class Iter_type>
-String_type get_str(Iter_type begin, Iter_type end)
+String_type get_str(Iter_type begin, Iter_type end, const typename String_type::allocator_type& allocator,
+    std::true_type /* contiguous */)
+{
+    return get_str_<String_type>(begin, end, allocator);
+}
+
+template<class String_type, class Iter_type>
+String_type get_str(Iter_type begin, Iter_type end, const typename String_type::allocator_type& allocator,
+    std::false_type /* contiguous */)
+{
+    typedef std::basic_string<typename String_type::value_type> Tmp_string_type;
+
+    const Tmp_string_type tmp(begin, end); // convert multipass iterators to string iterators
+
+    return get_str_<String_type>(tmp.begin(), tmp.end(), allocator);
+}
+
+// the allocator is that of the string returned, e.g. to create it in a memory resource
+//
+template<class String_type, class Iter_type>
+String_type get_str(Iter_type begin, Iter_type end,
+    const typename String_type::allocator_type& allocator = typename String_type::allocator_type())
+{
+    typedef typename String_type::value_type Char_type;
+    typedef typename std::iterator_traits<Iter_type>::value_type Iter_char_type;
+
+    return get_str<String_type>(begin, end, allocator,
+        std::integral_constant<bool,
+            Is_contiguous_iter<Iter_type>::value
+            && std::is_same<std::remove_const_t<Iter_char_type>, Char_type>::value>());
+}
+
+// true for the string types of values read in situ, which are views of the input
+//
+template<class String_type>
+struct Is_string_view : std::false_type
+{
+};
+
+template<class Char_type, class Traits>
+struct Is_string_view<boost::basic_string_ref<Char_type, Traits>> : std::true_type
+{
+};
+
+// lets append_esc_char_and_incr_iter() write over the text it is unescaping, which
+// works as no escape sequence is shorter than the character it stands for
+//
+template<class Char_type>
+struct In_place_output
+{
+    typedef Char_type value_type;
+
+    void operator+=(Char_type c)
+    {
+        *out_++ = c;
+    }
+
+    Char_type* out_;
+};
+
+// the in place version of substitute_esc_chars(), returns the new end of the string
+//
+template<class Char_type>
+Char_type* substitute_esc_chars_in_place(Char_type* begin, Char_type* end)
 {
-    const String_type tmp(begin, end); // convert multipass iterators to string iterators
+    if (end - begin < 2)
+    {
+        return end;
+    }
+
+    // the last character is not checked, it can't start an escape sequence
+    const Char_type* const end_minus_1(end - 1);
+    In_place_output<Char_type> output = { begin };
+    Char_type* substr_start = begin;
+    Char_type* i = begin;
+    while (i < end_minus_1)
+    {
+        i += find_esc_or_newline(static_cast<const Char_type*>(i), end_minus_1) - i;
+
+        if (i == end_minus_1)
+        {
+            break;
+        }
+        if (*i == '\n')
+        {
+            throw_error(i, "unescaped newline in string");
+        }
 
-    return get_str(tmp.begin(), tmp.end());
+        output.out_ = std::copy(substr_start, i, output.out_);
+
+        ++i; // skip the '\\'
+
+        append_esc_char_and_incr_iter(output, i, end);
+
+        substr_start = ++i;
+    }
+
+    return std::copy(substr_start, end, output.out_);
 }
 
+// true for containers with reserve(), i.e. all but map objects
+//
+template<class Container, class = void>
+struct Has_reserve : std::false_type
+{
+};
+
+template<class Container>
+struct Has_reserve<Container, std::conditional_t<true, void, decltype(std::declval<Container&>().reserve(0))>> : std::true_type
+{
+};
+
 // this class's methods get called by the spirit parse resulting
 // in the creation of a JSON object or array
 //
@@ -333,13 +476,59 @@ public:
     typedef typename Config_type::Object_type Object_type;
     typedef typename Config_type::Array_type Array_type;
     typedef typename String_type::value_type Char_type;
+    typedef typename Array_type::allocator_type Allocator_type;
+
+    Semantic_actions()
+        : value_p_(0)
+        , current_p_(0)
+        , sizes_(0)
+        , next_size_(0)
+        , pack_arrays_(false)
+    {
+    }
 
-    Semantic_actions(Value_type& value)
-        : value_(value)
+    // the strings, objects and arrays read are created with the allocator,
+    // e.g. one using a memory resource
+    //
+    Semantic_actions(Value_type& value, const Allocator_type& allocator = Allocator_type())
+        : value_p_(&value)
         , current_p_(0)
+        , sizes_(0)
+        , next_size_(0)
+        , pack_arrays_(false)
+        , allocator_(allocator)
+        , name_(make_name(allocator, internal_::Has_allocator<String_type>()))
     {
     }
 
+    // starts reading into another value, keeping the capacity of the stack
+    //
+    void reset(Value_type& value)
+    {
+        value_p_ = &value;
+        current_p_ = 0;
+        stack_.clear();
+        name_.clear();
+        sizes_ = 0;
+        next_size_ = 0;
+    }
+
+    // the number of elements of every array and object, in the order they begin, so each
+    // is created with its final capacity, see count_container_sizes()
+    //
+    void set_container_sizes(const std::vector<boost::uint32_t>* sizes)
+    {
+        sizes_ = sizes;
+        next_size_ = 0;
+    }
+
+    // arrays of only int64 or only real numbers are stored packed, see Value_impl::get_int64_array()
+    //
+    void set_pack_arrays(bool pack_arrays)
+    {
+        pack_arrays_ = pack_arrays;
+    }
+
     void begin_obj(Char_type c)
     {
         (void)c;
@@ -369,19 +558,22 @@ public:
         (void)c;
         assert(c == ']');
 
+        if (pack_arrays_)
+        {
+            pack_array(*current_p_);
+        }
+
         end_compound();
     }
 
     void new_name(Iter_type begin, Iter_type end)
     {
-        assert(current_p_->type() == obj_type);
-
-        name_ = get_str<String_type>(begin, end);
+        set_name(make_str(begin, end, Is_interned<String_type>()));
     }
 
     void new_str(Iter_type begin, Iter_type end)
     {
-        add_to_current(get_str<String_type>(begin, end));
+        add_to_current(make_str(begin, end, Is_interned<String_type>()));
     }
 
     void new_true(Iter_type begin, Iter_type end)
@@ -426,39 +618,176 @@ public:
         add_to_current(d);
     }
 
+    void new_number(const Json_number& number)
+    {
+        switch (number.kind)
+        {
+        case real_number:
+            new_real(number.real_value);
+            break;
+        case int64_number:
+            new_int(number.int_value);
+            break;
+        case uint64_number:
+            new_uint64(number.uint64_value);
+            break;
+        case not_a_number:
+            assert(false);
+            break;
+        }
+    }
+
+protected:
+    void set_name(String_type&& name)
+    {
+        assert(current_p_->type() == obj_type);
+
+        name_ = std::move(name);
+    }
+
+    void add_str(String_type&& s)
+    {
+        add_to_current(std::move(s));
+    }
+
 private:
     Semantic_actions& operator=(const Semantic_actions&);
     // to prevent "assignment operator could not be generated" warning
 
-    Value_type* add_first(const Value_type& value)
+    String_type make_str(Iter_type begin, Iter_type end, std::false_type /* interned */)
+    {
+        return get_str<String_type>(begin, end, convert_allocator<typename String_type::allocator_type>(allocator_));
+    }
+
+    // the text is unescaped into a temporary, which does not allocate for short strings
+    //
+    String_type make_str(Iter_type begin, Iter_type end, std::true_type /* interned */)
+    {
+        const std::basic_string<Char_type> str(get_str<std::basic_string<Char_type>>(begin, end));
+
+        return String_type(str.data(), str.size());
+    }
+
+    static String_type make_name(const Allocator_type& allocator, std::true_type /* has allocator */)
+    {
+        return String_type(convert_allocator<typename String_type::allocator_type>(allocator));
+    }
+
+    static String_type make_name(const Allocator_type&, std::false_type /* has allocator */)
+    {
+        return String_type();
+    }
+
+    // only allocators with a state, e.g. a memory resource, are passed on, others such as
+    // the allocator of a small vector could not be converted to that of a string
+    //
+    template<class Target_allocator>
+    static Target_allocator convert_allocator(const Allocator_type& allocator)
+    {
+        return convert_allocator<Target_allocator>(allocator, std::integral_constant<bool, !std::is_empty<Allocator_type>::value>());
+    }
+
+    template<class Target_allocator>
+    static Target_allocator convert_allocator(const Allocator_type& allocator, std::true_type /* stateful */)
+    {
+        return Target_allocator(allocator);
+    }
+
+    template<class Target_allocator>
+    static Target_allocator convert_allocator(const Allocator_type&, std::false_type /* stateful */)
+    {
+        return Target_allocator();
+    }
+
+    Value_type* add_first(Value_type&& value)
     {
         assert(current_p_ == 0);
 
-        value_ = value;
-        current_p_ = &value_;
+        *value_p_ = std::move(value);
+        current_p_ = value_p_;
         return current_p_;
     }
 
     template<class Array_or_obj>
     void begin_compound()
     {
+        Array_or_obj array_or_obj(convert_allocator<typename Array_or_obj::allocator_type>(allocator_));
+
+        if (sizes_ != 0 && next_size_ < sizes_->size())
+        {
+            reserve(array_or_obj, (*sizes_)[next_size_++], Has_reserve<Array_or_obj>());
+        }
+
         if (current_p_ == 0)
         {
-            add_first(Array_or_obj());
+            add_first(std::move(array_or_obj));
         }
         else
         {
             stack_.push_back(current_p_);
 
-            Array_or_obj new_array_or_obj; // avoid copy by building new array or object in place
+            current_p_ = add_to_current(std::move(array_or_obj));
+        }
+    }
+
+    template<class Array_or_obj>
+    static void reserve(Array_or_obj& array_or_obj, std::size_t size, std::true_type /* has reserve */)
+    {
+        array_or_obj.reserve(size);
+    }
+
+    template<class Array_or_obj>
+    static void reserve(Array_or_obj&, std::size_t, std::false_type /* has reserve */)
+    {
+    }
+
+    static void pack_array(Value_type& value)
+    {
+        const Array_type& array = static_cast<const Value_type&>(value).get_array();
+
+        if (array.empty())
+        {
+            return;
+        }
+
+        if (array.front().is_int64())
+        {
+            if (std::all_of(array.begin(), array.end(), [](const Value_type& v) { return v.is_int64(); }))
+            {
+                value = Value_type(packed_numbers<boost::int64_t>(array));
+            }
+        }
+        else if (is_real(array.front()))
+        {
+            if (std::all_of(array.begin(), array.end(), &is_real))
+            {
+                value = Value_type(packed_numbers<double>(array));
+            }
+        }
+    }
+
+    static bool is_real(const Value_type& value)
+    {
+        return value.type() == number_type && !value.is_int64() && !value.is_uint64();
+    }
+
+    template<class Number>
+    static std::vector<Number> packed_numbers(const Array_type& array)
+    {
+        std::vector<Number> numbers;
+        numbers.reserve(array.size());
 
-            current_p_ = add_to_current(new_array_or_obj);
+        for (const Value_type& v : array)
+        {
+            numbers.push_back(v.template get_value<Number>());
         }
+
+        return numbers;
     }
 
     void end_compound()
     {
-        if (current_p_ != &value_)
+        if (current_p_ != value_p_)
         {
             current_p_ = stack_.back();
 
@@ -466,82 +795,182 @@ private:
         }
     }
 
-    Value_type* add_to_current(const Value_type& value)
+    // the values are moved into place, so no subtree is ever copied
+    //
+    Value_type* add_to_current(Value_type&& value)
     {
         if (current_p_ == 0)
         {
-            return add_first(value);
+            return add_first(std::move(value));
         }
         else if (current_p_->type() == array_type)
         {
-            current_p_->get_array().push_back(value);
+            current_p_->get_array().push_back(std::move(value));
 
             return &current_p_->get_array().back();
         }
 
         assert(current_p_->type() == obj_type);
 
-        return &Config_type::add(current_p_->get_obj(), name_, value);
+        return &Config_type::add(current_p_->get_obj(), std::move(name_), std::move(value));
     }
 
-    Value_type& value_; // this is the object or array that is being created
+    Value_type* value_p_; // this is the object or array that is being created
     Value_type* current_p_; // the child object or array that is currently being constructed
 
     std::vector<Value_type*> stack_; // previous child objects and arrays
 
+    const std::vector<boost::uint32_t>* sizes_; // of the arrays and objects, if known
+    std::size_t next_size_;
+
+    bool pack_arrays_;
+
+    Allocator_type allocator_;
     String_type name_; // of current name/value pair
 };
 
-// the spirit grammer
+// the semantic actions of read_in_situ(), the strings and names are views of the
+// buffer being read, with their escape sequences replaced in place
 //
-template<class Value_type, class Iter_type>
-class Json_grammar : public spirit_namespace::grammar<Json_grammar<Value_type, Iter_type>>
+// The original text of each string changed is kept, so that the buffer can be
+// restored when the parse fails.
+//
+template<class Value_type>
+class In_situ_actions : public Semantic_actions<Value_type, const typename Value_type::String_type::value_type*>
 {
 public:
-    using Semantic_actions_t = Semantic_actions<Value_type, Iter_type>;
+    typedef typename Value_type::String_type String_type;
+    typedef typename String_type::value_type Char_type;
+    typedef Semantic_actions<Value_type, const Char_type*> Base_type;
 
-    Json_grammar(Semantic_actions_t& semantic_actions)
-        : actions_(semantic_actions)
+    In_situ_actions(Value_type& value)
+        : Base_type(value)
     {
     }
 
-    static void throw_not_value(Iter_type begin, Iter_type end)
+    void new_name(const Char_type* begin, const Char_type* end)
     {
-        (void)end;
-        throw_error(begin, "not a value");
+        this->set_name(unescape_in_place(begin, end));
     }
 
-    static void throw_not_array(Iter_type begin, Iter_type end)
+    void new_str(const Char_type* begin, const Char_type* end)
     {
-        (void)end;
-        throw_error(begin, "not an array");
+        this->add_str(unescape_in_place(begin, end));
     }
 
-    static void throw_not_object(Iter_type begin, Iter_type end)
+    // undoes the changes made to the buffer
+    //
+    void restore_buffer()
     {
-        (void)end;
-        throw_error(begin, "not an object");
+        std::size_t offset = saved_text_.size();
+
+        for (auto i = saved_strs_.rbegin(); i != saved_strs_.rend(); ++i)
+        {
+            offset -= i->second;
+
+            saved_text_.copy(i->first, i->second, offset);
+        }
     }
 
-    static void throw_not_pair(Iter_type begin, Iter_type end)
+private:
+    String_type unescape_in_place(const Char_type* begin, const Char_type* end)
     {
-        (void)end;
-        throw_error(begin, "not a pair");
+        assert(end - begin >= 2);
+
+        // read_in_situ() only passes buffers the caller allows to be changed
+        Char_type* const str_without_quotes = const_cast<Char_type*>(begin) + 1;
+        Char_type* const end_without_quotes = const_cast<Char_type*>(end) - 1;
+        const std::size_t length = end_without_quotes - str_without_quotes;
+
+        if (length >= 2 && *find_esc_or_newline(begin + 1, end - 2) == '\\')
+        {
+            saved_strs_.push_back(std::make_pair(str_without_quotes, length));
+            saved_text_.append(str_without_quotes, length);
+        }
+
+        return String_type(str_without_quotes,
+            substitute_esc_chars_in_place(str_without_quotes, end_without_quotes) - str_without_quotes);
     }
 
-    static void throw_not_colon(Iter_type begin, Iter_type end)
+    std::basic_string<Char_type> saved_text_;
+    std::vector<std::pair<Char_type*, std::size_t>> saved_strs_; // in the order they were read
+};
+
+// a spirit action calling a fixed method of the semantic actions object, e.g.
+//
+// Action< void ( Semantic_actions_t::* )( Char_type ), &Semantic_actions_t::begin_obj > begin_obj( actions );
+//
+template<class Method_type, Method_type method>
+class Action;
+
+template<class Actions_type, class... Args, void (Actions_type::*method)(Args...)>
+class Action<void (Actions_type::*)(Args...), method>
+{
+public:
+    explicit Action(Actions_type& actions)
+        : actions_(&actions)
     {
-        (void)end;
-        throw_error(begin, "no colon in pair");
     }
 
-    static void throw_not_string(Iter_type begin, Iter_type end)
+    void operator()(Args... args) const
     {
-        (void)end;
-        throw_error(begin, "not a string");
+        (actions_->*method)(args...);
     }
 
-    template<typename ScannerT>
+private:
+    Actions_type* actions_;
+};
+
+// the spirit grammer, Actions_type is Semantic_actions or anything with the same methods
+//
+template<class Actions_type, class Iter_type>
+class Json_grammar : public spirit_namespace::grammar<Json_grammar<Actions_type, Iter_type>>
+{
+public:
+    using Semantic_actions_t = Actions_type;
+
+    Json_grammar(Semantic_actions_t& semantic_actions)
+        : actions_(semantic_actions)
+    {
+    }
+
+    static void throw_not_value(Iter_type begin, Iter_type end)
+    {
+        (void)end;
+        throw_error(begin, "not a value");
+    }
+
+    static void throw_not_array(Iter_type begin, Iter_type end)
+    {
+        (void)end;
+        throw_error(begin, "not an array");
+    }
+
+    static void throw_not_object(Iter_type begin, Iter_type end)
+    {
+        (void)end;
+        throw_error(begin, "not an object");
+    }
+
+    static void throw_not_pair(Iter_type begin, Iter_type end)
+    {
+        (void)end;
+        throw_error(begin, "not a pair");
+    }
+
+    static void throw_not_colon(Iter_type begin, Iter_type end)
+    {
+        (void)end;
+        throw_error(begin, "no colon in pair");
+    }
+
+    static void throw_not_string(Iter_type begin, Iter_type end)
+    {
+        (void)end;
+        throw_error(begin, "not a string");
+    }
+
+    template<typename ScannerT>
     class definition
     {
     public:
@@ -549,29 +978,26 @@ public:
         {
             using namespace spirit_namespace;
 
-            typedef typename Value_type::String_type::value_type Char_type;
+            typedef typename Semantic_actions_t::Char_type Char_type;
 
             // first we convert the semantic action class methods to functors with the
-            // parameter signature expected by spirit
-
-            using Char_action = boost::function<void(Char_type)>;
-            using Str_action = boost::function<void(Iter_type, Iter_type)>;
-            using Real_action = boost::function<void(double)>;
-            using Int_action = boost::function<void(boost::int64_t)>;
-            using Uint64_action = boost::function<void(boost::uint64_t)>;
-
-            Char_action begin_obj(boost::bind(&Semantic_actions_t::begin_obj, &self.actions_, _1));
-            Char_action end_obj(boost::bind(&Semantic_actions_t::end_obj, &self.actions_, _1));
-            Char_action begin_array(boost::bind(&Semantic_actions_t::begin_array, &self.actions_, _1));
-            Char_action end_array(boost::bind(&Semantic_actions_t::end_array, &self.actions_, _1));
-            Str_action new_name(boost::bind(&Semantic_actions_t::new_name, &self.actions_, _1, _2));
-            Str_action new_str(boost::bind(&Semantic_actions_t::new_str, &self.actions_, _1, _2));
-            Str_action new_true(boost::bind(&Semantic_actions_t::new_true, &self.actions_, _1, _2));
-            Str_action new_false(boost::bind(&Semantic_actions_t::new_false, &self.actions_, _1, _2));
-            Str_action new_null(boost::bind(&Semantic_actions_t::new_null, &self.actions_, _1, _2));
-            Real_action new_real(boost::bind(&Semantic_actions_t::new_real, &self.actions_, _1));
-            Int_action new_int(boost::bind(&Semantic_actions_t::new_int, &self.actions_, _1));
-            Uint64_action new_uint64(boost::bind(&Semantic_actions_t::new_uint64, &self.actions_, _1));
+            // parameter signature expected by spirit, the method is a template argument
+            // so the calls are direct and can be inlined into the parser
+
+            typedef void (Semantic_actions_t::*Char_method)(Char_type);
+            typedef void (Semantic_actions_t::*Str_method)(Iter_type, Iter_type);
+            typedef void (Semantic_actions_t::*Number_method)(const Json_number&);
+
+            const Action<Char_method, &Semantic_actions_t::begin_obj> begin_obj(self.actions_);
+            const Action<Char_method, &Semantic_actions_t::end_obj> end_obj(self.actions_);
+            const Action<Char_method, &Semantic_actions_t::begin_array> begin_array(self.actions_);
+            const Action<Char_method, &Semantic_actions_t::end_array> end_array(self.actions_);
+            const Action<Str_method, &Semantic_actions_t::new_name> new_name(self.actions_);
+            const Action<Str_method, &Semantic_actions_t::new_str> new_str(self.actions_);
+            const Action<Str_method, &Semantic_actions_t::new_true> new_true(self.actions_);
+            const Action<Str_method, &Semantic_actions_t::new_false> new_false(self.actions_);
+            const Action<Str_method, &Semantic_actions_t::new_null> new_null(self.actions_);
+            const Action<Number_method, &Semantic_actions_t::new_number> new_number(self.actions_);
 
             // actual grammer
 
@@ -616,9 +1042,7 @@ public:
                         '"')];
 
             number_
-                = json_real_p[new_real]
-                | int64_p[new_int]
-                | uint64_p[new_uint64];
+                = json_number_p[new_number];
         }
 
         spirit_namespace::rule<ScannerT> json_, object_, members_, pair_, array_, elements_, value_, string_, number_;
@@ -651,15 +1075,492 @@ public:
     };
 };
 
+inline bool is_space_char(char c)
+{
+    // same set as spirit_namespace::space_p in the "C" locale
+    switch (c)
+    {
+    case ' ':
+    case '\t':
+    case '\n':
+    case '\v':
+    case '\f':
+    case '\r':
+        return true;
+    }
+    return false;
+}
+
+inline bool is_space_char(wchar_t c)
+{
+    if (static_cast<std::make_unsigned_t<wchar_t>>(c) < 0x80)
+    {
+        return is_space_char(static_cast<char>(c));
+    }
+    return std::iswspace(static_cast<wint_t>(c)) != 0;
+}
+
+template<class Char_type>
+bool is_hex_char(Char_type c)
+{
+    return ((c >= '0') && (c <= '9'))
+        || ((c >= 'a') && (c <= 'f'))
+        || ((c >= 'A') && (c <= 'F'));
+}
+
+// scanning primitives over a contiguous buffer of characters, they accept exactly
+// the tokens accepted by Json_grammar and its skipper
+//
+// When given a structural index of the buffer the lexer jumps from token to token
+// instead of looking at white space and string contents.
+//
+template<class Char_type>
+class Json_lexer
+{
+public:
+    Json_lexer(const Char_type* begin, const Char_type* end, const simd::Structural_index* index = nullptr)
+        : pos_(begin)
+        , end_(end)
+        , base_(begin)
+        , next_token_(nullptr)
+        , tokens_end_(nullptr)
+    {
+        if (index != nullptr)
+        {
+            next_token_ = index->positions().data();
+            tokens_end_ = next_token_ + index->positions().size();
+        }
+    }
+
+    const Char_type* pos() const { return pos_; }
+
+    const Char_type* end() const { return end_; }
+
+    void set_pos(const Char_type* pos) { pos_ = pos; }
+
+    bool at_end() const { return pos_ == end_; }
+
+    Char_type peek() const
+    {
+        assert(!at_end());
+        return *pos_;
+    }
+
+    bool consume(Char_type c)
+    {
+        if (pos_ != end_ && *pos_ == c)
+        {
+            ++pos_;
+            return true;
+        }
+        return false;
+    }
+
+    // skips white space, "// ..." and "/* ... */" comments
+    //
+    void skip_space_and_comments()
+    {
+        if (next_token_ != nullptr)
+        {
+            skip_to_next_token(); // indexed text has no comments
+            return;
+        }
+
+        for (;;)
+        {
+            skip_space();
+
+            if (pos_ == end_ || *pos_ != '/' || !skip_comment())
+            {
+                return;
+            }
+        }
+    }
+
+    void skip_space()
+    {
+        while (pos_ != end_ && is_space_char(*pos_))
+        {
+            ++pos_;
+        }
+    }
+
+    // on success [first, last) spans the string including both quotes
+    //
+    bool scan_string(const Char_type*& first, const Char_type*& last)
+    {
+        assert(peek() == '"');
+
+        if (next_token_ != nullptr)
+        {
+            // the closing quote is the next token after the opening one
+            advance_next_token(pos_ + 1);
+            assert(next_token_ != tokens_end_ && base_[*next_token_] == '"');
+
+            first = pos_;
+            last = base_ + *next_token_ + 1;
+            pos_ = last;
+            return true;
+        }
+
+        for (const Char_type* i = pos_ + 1; i != end_;)
+        {
+            i = simd::find_either(i, end_, Char_type('"'), Char_type('\\'));
+
+            if (i == end_)
+            {
+                break;
+            }
+            if (*i == '"')
+            {
+                first = pos_;
+                last = i + 1;
+                pos_ = last;
+                return true;
+            }
+
+            i = skip_escape(i + 1);
+            if (i == nullptr)
+            {
+                break;
+            }
+        }
+        return false;
+    }
+
+    bool scan_literal(const char* literal)
+    {
+        const Char_type* i = pos_;
+        for (; *literal != 0; ++i, ++literal)
+        {
+            if (i == end_ || *i != *literal)
+            {
+                return false;
+            }
+        }
+        pos_ = i;
+        return true;
+    }
+
+    bool scan_number(Json_number& number)
+    {
+        pos_ = scan_json_number(pos_, end_, number);
+        return number.kind != not_a_number;
+    }
+
+private:
+    void advance_next_token(const Char_type* pos)
+    {
+        const boost::uint32_t offset = static_cast<boost::uint32_t>(pos - base_);
+
+        while (next_token_ != tokens_end_ && *next_token_ < offset)
+        {
+            ++next_token_;
+        }
+    }
+
+    // any non space character following white space is indexed
+    //
+    void skip_to_next_token()
+    {
+        if (pos_ == end_ || !is_space_char(*pos_))
+        {
+            return;
+        }
+
+        advance_next_token(pos_);
+
+        pos_ = (next_token_ != tokens_end_) ? base_ + *next_token_ : end_;
+    }
+
+    bool skip_comment()
+    {
+        assert(*pos_ == '/');
+
+        const Char_type* i = pos_ + 1;
+        if (i == end_)
+        {
+            return false;
+        }
+        if (*i == '/')
+        {
+            while (++i != end_ && *i != '\n' && *i != '\r')
+            {
+            }
+            if (i != end_ && *i == '\r')
+            {
+                ++i;
+            }
+            if (i != end_ && *i == '\n')
+            {
+                ++i;
+            }
+            pos_ = i;
+            return true;
+        }
+        if (*i == '*')
+        {
+            for (++i; i != end_ && i + 1 != end_; ++i)
+            {
+                if (i[0] == '*' && i[1] == '/')
+                {
+                    pos_ = i + 2;
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    // 'i' points past the backslash, returns the end of the escape sequence or null
+    // if it is malformed, mirrors spirit_namespace::lex_escape_ch_p which limits
+    // "\xHH..." escapes to the range of char even for wide input
+    //
+    const Char_type* skip_escape(const Char_type* i) const
+    {
+        if (i == end_)
+        {
+            return nullptr;
+        }
+        if (*i != 'x' && *i != 'X')
+        {
+            return i + 1;
+        }
+
+        typedef std::numeric_limits<char> Limits;
+
+        const int max_digits = Limits::digits / 4 + 1;
+        const boost::uint64_t max_value = static_cast<boost::uint64_t>((Limits::max)());
+
+        boost::uint64_t n = 0;
+        int digits = 0;
+        for (++i; i != end_ && digits < max_digits && is_hex_char(*i); ++i, ++digits)
+        {
+            n = (n << 4) + static_cast<boost::uint64_t>(hex_to_num(*i));
+            if (n > max_value)
+            {
+                return nullptr;
+            }
+        }
+        return digits == 0 ? nullptr : i;
+    }
+
+    const Char_type* pos_;
+    const Char_type* end_;
+    const Char_type* base_;
+    const boost::uint32_t* next_token_;
+    const boost::uint32_t* tokens_end_;
+};
+
+// hand written recursive descent parser for contiguous input, it makes the same
+// calls to the semantic actions as Json_grammar does
+//
+template<class Actions_type, class Char_type>
+class Json_fast_parser
+{
+public:
+    Json_fast_parser(Actions_type& actions, const Char_type* begin, const Char_type* end,
+        const simd::Structural_index* index = nullptr)
+        : actions_(actions)
+        , lexer_(begin, end, index)
+    {
+    }
+
+    // returns the position past the last character of the value read
+    //
+    const Char_type* parse()
+    {
+        if (!parse_value())
+        {
+            throw_error(lexer_.pos(), "not a value");
+        }
+        return lexer_.pos();
+    }
+
+private:
+    typedef Json_lexer<Char_type> Lexer_t;
+
+    // returns false without calling any action if there is no value at the current position
+    //
+    bool parse_value()
+    {
+        lexer_.skip_space_and_comments();
+
+        if (lexer_.at_end())
+        {
+            return false;
+        }
+
+        const Char_type* first = lexer_.pos();
+        const Char_type* last = first;
+
+        switch (lexer_.peek())
+        {
+        case '"':
+            if (!lexer_.scan_string(first, last))
+            {
+                return false;
+            }
+            actions_.new_str(first, last);
+            return true;
+        case '{':
+            parse_object();
+            return true;
+        case '[':
+            parse_array();
+            return true;
+        case 't':
+            if (!lexer_.scan_literal("true"))
+            {
+                return false;
+            }
+            actions_.new_true(first, lexer_.pos());
+            return true;
+        case 'f':
+            if (!lexer_.scan_literal("false"))
+            {
+                return false;
+            }
+            actions_.new_false(first, lexer_.pos());
+            return true;
+        case 'n':
+            if (!lexer_.scan_literal("null"))
+            {
+                return false;
+            }
+            actions_.new_null(first, lexer_.pos());
+            return true;
+        default:
+            return parse_number();
+        }
+    }
+
+    bool parse_number()
+    {
+        Json_number number;
+        if (!lexer_.scan_number(number))
+        {
+            return false;
+        }
+        actions_.new_number(number);
+        return true;
+    }
+
+    void parse_object()
+    {
+        lexer_.consume('{');
+        actions_.begin_obj('{');
+
+        if (parse_pair())
+        {
+            for (;;)
+            {
+                lexer_.skip_space_and_comments();
+
+                const Char_type* comma = lexer_.pos();
+
+                if (!lexer_.consume(','))
+                {
+                    break;
+                }
+                if (!parse_pair())
+                {
+                    lexer_.set_pos(comma);
+                    break;
+                }
+            }
+        }
+
+        lexer_.skip_space_and_comments();
+
+        if (!lexer_.consume('}'))
+        {
+            throw_error(lexer_.pos(), "not an object");
+        }
+        actions_.end_obj('}');
+    }
+
+    bool parse_pair()
+    {
+        lexer_.skip_space_and_comments();
+
+        const Char_type* first = nullptr;
+        const Char_type* last = nullptr;
+
+        if (lexer_.at_end() || lexer_.peek() != '"' || !lexer_.scan_string(first, last))
+        {
+            return false;
+        }
+        actions_.new_name(first, last);
+
+        lexer_.skip_space_and_comments();
+
+        if (!lexer_.consume(':'))
+        {
+            throw_error(lexer_.pos(), "no colon in pair");
+        }
+        if (!parse_value())
+        {
+            throw_error(lexer_.pos(), "not a value");
+        }
+        return true;
+    }
+
+    void parse_array()
+    {
+        lexer_.consume('[');
+        actions_.begin_array('[');
+
+        if (parse_value())
+        {
+            for (;;)
+            {
+                lexer_.skip_space_and_comments();
+
+                const Char_type* comma = lexer_.pos();
+
+                if (!lexer_.consume(','))
+                {
+                    break;
+                }
+                if (!parse_value())
+                {
+                    lexer_.set_pos(comma);
+                    break;
+                }
+            }
+        }
+
+        lexer_.skip_space_and_comments();
+
+        if (!lexer_.consume(']'))
+        {
+            throw_error(lexer_.pos(), "not an array");
+        }
+        actions_.end_array(']');
+    }
+
+    Json_fast_parser& operator=(const Json_fast_parser&); // to prevent "assignment operator could not be generated" warning
+
+    Actions_type& actions_;
+    Lexer_t lexer_;
+};
+
+// the allocator of the strings, objects and arrays of a value
+//
+template<class Value_type>
+using Allocator_of = typename Value_type::Array::allocator_type;
+
 template<class Iter_type, class Value_type>
-void add_posn_iter_and_read_range_or_throw(Iter_type begin, Iter_type end, Value_type& value, bool allow_trailing_chars)
+void add_posn_iter_and_read_range_or_throw(Iter_type begin, Iter_type end, Value_type& value, bool allow_trailing_chars,
+    const Allocator_of<Value_type>& allocator = Allocator_of<Value_type>())
 {
     using Posn_iter_t = spirit_namespace::position_iterator<Iter_type>;
 
     const Posn_iter_t posn_begin(begin, end);
     const Posn_iter_t posn_end(end, end);
 
-    read_range_or_throw(posn_begin, posn_end, value, allow_trailing_chars);
+    read_range_or_throw(posn_begin, posn_end, value, allow_trailing_chars, allocator);
 }
 
 template<class Istream_type>
@@ -681,25 +1582,24 @@ struct Multi_pass_iters
     Mp_iter end_;
 };
 
-// reads a JSON Value from a pair of input iterators throwing an exception on invalid input, e.g.
-//
-// string::const_iterator start = str.begin();
-// const string::const_iterator next = read_range_or_throw( str.begin(), str.end(), value, allow_trailing_chars );
-//
-// The iterator 'next' will point to the character past the
-// last one read.
+// true if the input can be read by Json_fast_parser instead of Json_grammar
 //
-template<class Iter_type, class Value_type>
-Iter_type read_range_or_throw(Iter_type begin, Iter_type end, Value_type& value, bool allow_trailing_chars)
+template<class Iter_type, class Char_type>
+struct Is_contiguous_input
+    : std::integral_constant<bool,
+          Is_contiguous_iter<Iter_type>::value
+              && std::is_same<std::remove_const_t<typename std::iterator_traits<Iter_type>::value_type>, Char_type>::value>
 {
-    Semantic_actions<Value_type, Iter_type> semantic_actions(value);
+};
 
+template<class Actions_type, class Iter_type>
+Iter_type parse_with_grammar_or_throw(const Json_grammar<Actions_type, Iter_type>& grammar,
+    Iter_type begin, Iter_type end, bool allow_trailing_chars)
+{
     const auto skipper = spirit_namespace::space_p
         | spirit_namespace::comment_p("//")
         | spirit_namespace::comment_p("/*", "*/");
-    spirit_namespace::parse_info<Iter_type> info = spirit_namespace::parse(begin, end,
-        Json_grammar<Value_type, Iter_type>(semantic_actions),
-        skipper);
+    spirit_namespace::parse_info<Iter_type> info = spirit_namespace::parse(begin, end, grammar, skipper);
 
     if (!info.hit)
     {
@@ -720,6 +1620,154 @@ Iter_type read_range_or_throw(Iter_type begin, Iter_type end, Value_type& value,
     return info.stop;
 }
 
+template<class Iter_type, class Value_type>
+Iter_type read_range_or_throw(Iter_type begin, Iter_type end, Value_type& value, bool allow_trailing_chars,
+    const Allocator_of<Value_type>& allocator, std::false_type /* contiguous */)
+{
+    Semantic_actions<Value_type, Iter_type> semantic_actions(value, allocator);
+
+    return parse_with_grammar_or_throw(Json_grammar<Semantic_actions<Value_type, Iter_type>, Iter_type>(semantic_actions),
+        begin, end, allow_trailing_chars);
+}
+
+// texts of at least this size are indexed with simd::Structural_index before parsing
+//
+const std::size_t structural_index_min_size = 64 * 1024;
+
+inline bool build_structural_index(const char* begin, const char* end, simd::Structural_index& index,
+    std::size_t min_size = structural_index_min_size)
+{
+    return static_cast<std::size_t>(end - begin) >= min_size
+        && index.build(begin, end);
+}
+
+inline bool build_structural_index(const wchar_t*, const wchar_t*, simd::Structural_index&,
+    std::size_t = structural_index_min_size)
+{
+    return false;
+}
+
+// counts the elements of every array and object of an indexed text, in the order they
+// begin, by walking the structural characters only: an array or object has one element
+// if anything but its end follows its beginning, and one more for each comma
+//
+// Invalid text gives meaningless sizes, which only matters to the capacities reserved.
+//
+template<class Char_type>
+void count_container_sizes(const Char_type* text, const simd::Structural_index& index,
+    std::vector<boost::uint32_t>& sizes, std::vector<boost::uint32_t>& open)
+{
+    sizes.clear();
+    open.clear();
+
+    for (const boost::uint32_t pos : index.positions())
+    {
+        switch (text[pos])
+        {
+        case '{':
+        case '[':
+            if (!open.empty() && sizes[open.back()] == 0)
+            {
+                sizes[open.back()] = 1;
+            }
+            open.push_back(static_cast<boost::uint32_t>(sizes.size()));
+            sizes.push_back(0);
+            break;
+        case '}':
+        case ']':
+            if (!open.empty())
+            {
+                open.pop_back();
+            }
+            break;
+        case ',':
+            if (!open.empty())
+            {
+                ++sizes[open.back()];
+            }
+            break;
+        case ':':
+            break;
+        default: // a string or scalar
+            if (!open.empty() && sizes[open.back()] == 0)
+            {
+                sizes[open.back()] = 1;
+            }
+            break;
+        }
+    }
+}
+
+template<class Actions_type, class Char_type>
+const Char_type* parse_contiguous_or_throw(Actions_type& semantic_actions,
+    simd::Structural_index& index, const Char_type* first, const Char_type* last, bool allow_trailing_chars)
+{
+    const bool indexed = build_structural_index(first, last, index);
+
+    return parse_contiguous_or_throw(semantic_actions, indexed ? &index : nullptr, first, last, allow_trailing_chars);
+}
+
+template<class Actions_type, class Char_type>
+const Char_type* parse_contiguous_or_throw(Actions_type& semantic_actions,
+    const simd::Structural_index* index, const Char_type* first, const Char_type* last, bool allow_trailing_chars)
+{
+    Json_fast_parser<Actions_type, Char_type> parser(semantic_actions, first, last, index);
+
+    const Char_type* const stop = parser.parse();
+
+    // look for extra trailing characters
+    if (!allow_trailing_chars)
+    {
+        Json_lexer<Char_type> lexer(stop, last);
+        lexer.skip_space();
+        if (!lexer.at_end())
+        {
+            throw_error(lexer.pos(), "unexpected trailing characters");
+        }
+    }
+
+    return stop;
+}
+
+template<class Iter_type, class Value_type>
+Iter_type read_range_or_throw(Iter_type begin, Iter_type end, Value_type& value, bool allow_trailing_chars,
+    const Allocator_of<Value_type>& allocator, std::true_type /* contiguous */)
+{
+    typedef typename Value_type::String_type::value_type Char_type;
+
+    const Char_type* const first = (begin == end) ? nullptr : &*begin;
+    const Char_type* const last = first + (end - begin);
+
+    Semantic_actions<Value_type, const Char_type*> semantic_actions(value, allocator);
+    simd::Structural_index index;
+
+    return begin + (parse_contiguous_or_throw(semantic_actions, index, first, last, allow_trailing_chars) - first);
+}
+
+// reads a JSON Value from a pair of input iterators throwing an exception on invalid input, e.g.
+//
+// string::const_iterator start = str.begin();
+// const string::const_iterator next = read_range_or_throw( str.begin(), str.end(), value, allow_trailing_chars );
+//
+// The iterator 'next' will point to the character past the
+// last one read.
+//
+// Contiguous input, i.e. string iterators and character pointers, is read by the hand
+// written Json_fast_parser, any other iterator is read by the spirit grammar.
+//
+template<class Iter_type, class Value_type>
+Iter_type read_range_or_throw(Iter_type begin, Iter_type end, Value_type& value, bool allow_trailing_chars,
+    const Allocator_of<Value_type>& allocator = Allocator_of<Value_type>())
+{
+    typedef typename Value_type::String_type::value_type Char_type;
+
+    static_assert(!Is_string_view<typename Value_type::String_type>::value,
+        "values whose strings are views can only be read by read_in_situ()");
+
+    return read_range_or_throw(begin, end, value, allow_trailing_chars, allocator,
+        Is_contiguous_input<Iter_type, Char_type>());
+}
+
 // reads a JSON Value from a pair of input iterators, e.g.
 //
 // string::const_iterator start = str.begin();
@@ -729,11 +1777,12 @@ Iter_type read_range_or_throw(Iter_type begin, Iter_type end, Value_type& value,
 // last one read.
 //
 template<class Iter_type, class Value_type>
-bool read_range(Iter_type& begin, Iter_type end, Value_type& value, bool allow_trailing_chars)
+bool read_range(Iter_type& begin, Iter_type end, Value_type& value, bool allow_trailing_chars,
+    const Allocator_of<Value_type>& allocator = Allocator_of<Value_type>())
 {
     try
     {
-        begin = read_range_or_throw(begin, end, value, allow_trailing_chars);
+        begin = read_range_or_throw(begin, end, value, allow_trailing_chars, allocator);
 
         return true;
     }
@@ -747,12 +1796,19 @@ bool read_range(Iter_type& begin, Iter_type end, Value_type& value, bool allow_t
 //
 // const bool success = read_string( str, value );
 //
+// The read functions take an optional allocator for the strings, objects and arrays
+// of the value, e.g. to read a Value_pmr into a memory resource:
+//
+// std::pmr::monotonic_buffer_resource arena;
+// Value_pmr value;
+// const bool success = read_string( str, value, &arena );
+//
 template<class String_type, class Value_type>
-bool read_string(const String_type& s, Value_type& value)
+bool read_string(const String_type& s, Value_type& value, const Allocator_of<Value_type>& allocator = Allocator_of<Value_type>())
 {
     typename String_type::const_iterator begin = s.begin();
 
-    return read_range(begin, s.end(), value, false);
+    return read_range(begin, s.end(), value, false, allocator);
 }
 
 // reads a JSON Value from a string throwing an exception on invalid input, e.g.
@@ -760,21 +1816,127 @@ bool read_string(const String_type& s, Value_type& value)
 // read_string_or_throw( is, value );
 //
 template<class String_type, class Value_type>
-void read_string_or_throw(const String_type& s, Value_type& value)
+void read_string_or_throw(const String_type& s, Value_type& value, const Allocator_of<Value_type>& allocator = Allocator_of<Value_type>())
+{
+    try
+    {
+        read_range_or_throw(s.begin(), s.end(), value, false, allocator);
+    }
+    catch (const std::runtime_error&)
+    {
+        // the fast parser does not track lines and columns,
+        // so the input is parsed again to report the error position
+        add_posn_iter_and_read_range_or_throw(s.begin(), s.end(), value, false, allocator);
+    }
+}
+
+// reads a JSON Value from an array of characters without copying it, e.g.
+//
+// const bool success = read_chars( buffer, buffer + length, value );
+//
+template<class Char_type, class Value_type>
+bool read_chars(const Char_type* begin, const Char_type* end, Value_type& value,
+    const Allocator_of<Value_type>& allocator = Allocator_of<Value_type>())
 {
-    add_posn_iter_and_read_range_or_throw(s.begin(), s.end(), value, false);
+    return read_range(begin, end, value, false, allocator);
 }
 
+// reads a JSON Value from an array of characters throwing an exception on invalid input, e.g.
+//
+// read_chars_or_throw( buffer, buffer + length, value );
+//
+template<class Char_type, class Value_type>
+void read_chars_or_throw(const Char_type* begin, const Char_type* end, Value_type& value,
+    const Allocator_of<Value_type>& allocator = Allocator_of<Value_type>())
+{
+    try
+    {
+        read_range_or_throw(begin, end, value, false, allocator);
+    }
+    catch (const std::runtime_error&)
+    {
+        // see read_string_or_throw()
+        add_posn_iter_and_read_range_or_throw(begin, end, value, false, allocator);
+    }
+}
+
+#if defined(JSON_SPIRIT_VALUE_ENABLED) || defined(JSON_SPIRIT_WVALUE_ENABLED)
+// reads a JSON Value in situ, i.e. without copying any strings, e.g.
+//
+// const bool success = read_in_situ( buffer, buffer + length, value );
+//
+// The strings and names of the value are views of the buffer, see vValue. Escape
+// sequences are replaced in place, so the buffer is changed, unless the text
+// turns out to be invalid, in which case the buffer is restored.
+//
+template<class Char_type, class Value_type>
+bool read_in_situ(Char_type* begin, Char_type* end, Value_type& value)
+{
+    static_assert(Is_string_view<typename Value_type::String_type>::value,
+        "read_in_situ() reads values whose strings are views, e.g. vValue");
+
+    In_situ_actions<Value_type> semantic_actions(value);
+    simd::Structural_index index;
+
+    try
+    {
+        parse_contiguous_or_throw(semantic_actions, index,
+            static_cast<const Char_type*>(begin), static_cast<const Char_type*>(end), false);
+
+        return true;
+    }
+    catch (...)
+    {
+        semantic_actions.restore_buffer();
+
+        return false;
+    }
+}
+
+// reads a JSON Value in situ throwing an exception on invalid input, e.g.
+//
+// read_in_situ_or_throw( buffer, buffer + length, value );
+//
+template<class Char_type, class Value_type>
+void read_in_situ_or_throw(Char_type* begin, Char_type* end, Value_type& value)
+{
+    static_assert(Is_string_view<typename Value_type::String_type>::value,
+        "read_in_situ_or_throw() reads values whose strings are views, e.g. vValue");
+
+    In_situ_actions<Value_type> semantic_actions(value);
+    simd::Structural_index index;
+
+    try
+    {
+        parse_contiguous_or_throw(semantic_actions, index,
+            static_cast<const Char_type*>(begin), static_cast<const Char_type*>(end), false);
+    }
+    catch (const std::runtime_error&)
+    {
+        semantic_actions.restore_buffer();
+
+        // see read_string_or_throw(), a value owning its strings is used
+        // as the buffer must not be changed again
+        Value_impl<Config_vector<std::basic_string<Char_type>>> owning_value;
+
+        add_posn_iter_and_read_range_or_throw(static_cast<const Char_type*>(begin),
+            static_cast<const Char_type*>(end), owning_value, false);
+
+        throw;
+    }
+}
+#endif
+
 // reads a JSON Value from a stream, e.g.
 //
 // const bool success = read_stream( is, value );
 //
 template<class Istream_type, class Value_type>
-bool read_stream(Istream_type& is, Value_type& value)
+bool read_stream(Istream_type& is, Value_type& value, const Allocator_of<Value_type>& allocator = Allocator_of<Value_type>())
 {
     Multi_pass_iters<Istream_type> mp_iters(is);
 
-    return read_range(mp_iters.begin_, mp_iters.end_, value, false);
+    return read_range(mp_iters.begin_, mp_iters.end_, value, false, allocator);
 }
 
 // reads a JSON Value from a stream throwing an exception on invalid input, e.g.
@@ -782,12 +1944,174 @@ bool read_stream(Istream_type& is, Value_type& value)
 // read_stream_or_throw( is, value );
 //
 template<class Istream_type, class Value_type>
-void read_stream_or_throw(Istream_type& is, Value_type& value)
+void read_stream_or_throw(Istream_type& is, Value_type& value, const Allocator_of<Value_type>& allocator = Allocator_of<Value_type>())
 {
     const Multi_pass_iters<Istream_type> mp_iters(is);
 
-    add_posn_iter_and_read_range_or_throw(mp_iters.begin_, mp_iters.end_, value, false);
+    add_posn_iter_and_read_range_or_throw(mp_iters.begin_, mp_iters.end_, value, false, allocator);
 }
+
+// Reads one JSON value after another reusing everything that the functions above
+// set up per call: the semantic actions with their stack, the structural index
+// and, for streams, the spirit grammar together with its definition. Worth it
+// when reading many small texts, e.g.
+//
+// Reader< mValue > reader;
+// for( const string& message : messages ) { mValue value; if( reader.read( message, value ) ) ... }
+//
+// A Reader is not thread safe, use one per thread.
+//
+// With the presize_containers option, strings and character arrays are scanned for the
+// number of elements of each array and object first, so every one of them is allocated
+// once, at its final size, rather than grown element by element. That pays off for large
+// arrays and objects, e.g.
+//
+// Reader< Value > reader( presize_containers );
+//
+// With the pack_numeric_arrays option, the arrays holding only int64 numbers or only real
+// numbers are stored as vectors of those numbers, which take half the memory of their values
+// and can be used directly, see Value_impl::get_int64_array(). The numbers are allocated on
+// the heap, whatever the allocator of the value.
+//
+enum Reader_options
+{
+    presize_containers = 0x01,
+    pack_numeric_arrays = 0x02
+};
+
+template<class Value_type>
+class Reader
+{
+public:
+    typedef typename Value_type::String_type String_type;
+    typedef typename String_type::value_type Char_type;
+    typedef typename String_type::const_iterator Const_iter_type;
+    typedef std::basic_istream<Char_type> Istream_type;
+
+    explicit Reader(int options = 0)
+        : presize_((options & presize_containers) != 0)
+        , stream_grammar_(stream_actions_)
+        , posn_grammar_(posn_actions_)
+    {
+        const bool pack_arrays = (options & pack_numeric_arrays) != 0;
+
+        actions_.set_pack_arrays(pack_arrays);
+        stream_actions_.set_pack_arrays(pack_arrays);
+        posn_actions_.set_pack_arrays(pack_arrays);
+    }
+
+    Reader(const Reader&) = delete;
+    Reader& operator=(const Reader&) = delete;
+
+    bool read(const String_type& s, Value_type& value)
+    {
+        Const_iter_type begin = s.begin();
+
+        return read(begin, s.end(), value);
+    }
+
+    void read_or_throw(const String_type& s, Value_type& value)
+    {
+        try
+        {
+            read_range_or_throw(s.begin(), s.end(), value);
+        }
+        catch (const std::runtime_error&)
+        {
+            // see read_string_or_throw()
+            add_posn_iter_and_read_range_or_throw(s.begin(), s.end(), value, false);
+        }
+    }
+
+    bool read(Const_iter_type& begin, Const_iter_type end, Value_type& value)
+    {
+        try
+        {
+            begin = read_range_or_throw(begin, end, value);
+
+            return true;
+        }
+        catch (...)
+        {
+            return false;
+        }
+    }
+
+    void read_or_throw(Const_iter_type& begin, Const_iter_type end, Value_type& value)
+    {
+        begin = read_range_or_throw(begin, end, value);
+    }
+
+    bool read(Istream_type& is, Value_type& value)
+    {
+        const Multi_pass_iters<Istream_type> mp_iters(is);
+
+        try
+        {
+            stream_actions_.reset(value);
+            parse_with_grammar_or_throw(stream_grammar_, mp_iters.begin_, mp_iters.end_, false);
+
+            return true;
+        }
+        catch (...)
+        {
+            return false;
+        }
+    }
+
+    void read_or_throw(Istream_type& is, Value_type& value)
+    {
+        const Multi_pass_iters<Istream_type> mp_iters(is);
+
+        const Posn_iter_t begin(mp_iters.begin_, mp_iters.end_);
+        const Posn_iter_t end(mp_iters.end_, mp_iters.end_);
+
+        posn_actions_.reset(value);
+        parse_with_grammar_or_throw(posn_grammar_, begin, end, false);
+    }
+
+private:
+    typedef typename Multi_pass_iters<Istream_type>::Mp_iter Stream_iter_t;
+    typedef spirit_namespace::position_iterator<Stream_iter_t> Posn_iter_t;
+
+    Const_iter_type read_range_or_throw(Const_iter_type begin, Const_iter_type end, Value_type& value)
+    {
+        const Char_type* const first = (begin == end) ? nullptr : &*begin;
+        const Char_type* const last = first + (end - begin);
+
+        actions_.reset(value);
+
+        if (!presize_)
+        {
+            return begin + (parse_contiguous_or_throw(actions_, index_, first, last, false) - first);
+        }
+
+        // any text that can be indexed is, as the sizes are counted from the index
+        const bool indexed = build_structural_index(first, last, index_, 0);
+
+        if (indexed)
+        {
+            count_container_sizes(first, index_, sizes_, open_);
+            actions_.set_container_sizes(&sizes_);
+        }
+
+        return begin + (parse_contiguous_or_throw(actions_, indexed ? &index_ : nullptr, first, last, false) - first);
+    }
+
+    bool presize_;
+
+    Semantic_actions<Value_type, const Char_type*> actions_;
+    simd::Structural_index index_;
+    std::vector<boost::uint32_t> sizes_; // of the arrays and objects with presize_containers
+    std::vector<boost::uint32_t> open_;
+
+    Semantic_actions<Value_type, Stream_iter_t> stream_actions_;
+    Json_grammar<Semantic_actions<Value_type, Stream_iter_t>, Stream_iter_t> stream_grammar_;
+
+    // read_or_throw() tracks positions for the error message like read_stream_or_throw()
+    Semantic_actions<Value_type, Posn_iter_t> posn_actions_;
+    Json_grammar<Semantic_actions<Value_type, Posn_iter_t>, Posn_iter_t> posn_grammar_;
+};
 }
 
 #endif
@@ -0,0 +1,255 @@
+#ifndef JSON_SPIRIT_SAX_READER
+#define JSON_SPIRIT_SAX_READER
+
+//          Copyright John W. Wilkinson 2007 - 2014
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+
+// json spirit version 4.08
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include "json_spirit_reader_template.h"
+
+namespace json_spirit
+{
+// These functions read JSON text without building a Value, instead they tell a handler
+// about each thing found in the order it appears. The handler can be any class with
+// these methods, where String_type is the string type of the input:
+//
+// void begin_obj();
+// void end_obj();
+// void begin_array();
+// void end_array();
+// void key( const String_type& name );          // the name of the pair whose value follows
+// void string_value( const String_type& s );
+// void int64_value( boost::int64_t i );
+// void uint64_value( boost::uint64_t ui );     // integers too large for int64
+// void real_value( double d );
+// void bool_value( bool b );
+// void null_value();
+//
+// e.g. summing all numbers of an array without storing them
+//
+// struct Summer : Null_sax_handler< std::string > { double sum = 0; void real_value( double d ) { sum += d; } ... };
+// Summer summer;
+// const bool success = read_sax( str, summer );
+//
+// On invalid input the handler has seen the events up to the error.
+
+// a handler that ignores everything, derive from it to handle only some events
+//
+template<class String_type>
+class Null_sax_handler
+{
+public:
+    void begin_obj() {}
+    void end_obj() {}
+    void begin_array() {}
+    void end_array() {}
+    void key(const String_type&) {}
+    void string_value(const String_type&) {}
+    void int64_value(boost::int64_t) {}
+    void uint64_value(boost::uint64_t) {}
+    void real_value(double) {}
+    void bool_value(bool) {}
+    void null_value() {}
+};
+
+// turns the calls the parsers make on Semantic_actions into calls on a handler
+//
+template<class Handler_type, class String_type, class Iter_type>
+class Sax_actions
+{
+public:
+    typedef typename String_type::value_type Char_type;
+
+    explicit Sax_actions(Handler_type& handler)
+        : handler_(&handler)
+    {
+    }
+
+    void begin_obj(Char_type)
+    {
+        handler_->begin_obj();
+    }
+
+    void end_obj(Char_type)
+    {
+        handler_->end_obj();
+    }
+
+    void begin_array(Char_type)
+    {
+        handler_->begin_array();
+    }
+
+    void end_array(Char_type)
+    {
+        handler_->end_array();
+    }
+
+    void new_name(Iter_type begin, Iter_type end)
+    {
+        handler_->key(get_str<String_type>(begin, end));
+    }
+
+    void new_str(Iter_type begin, Iter_type end)
+    {
+        handler_->string_value(get_str<String_type>(begin, end));
+    }
+
+    void new_true(Iter_type, Iter_type)
+    {
+        handler_->bool_value(true);
+    }
+
+    void new_false(Iter_type, Iter_type)
+    {
+        handler_->bool_value(false);
+    }
+
+    void new_null(Iter_type, Iter_type)
+    {
+        handler_->null_value();
+    }
+
+    void new_number(const Json_number& number)
+    {
+        switch (number.kind)
+        {
+        case real_number:
+            handler_->real_value(number.real_value);
+            break;
+        case int64_number:
+            handler_->int64_value(number.int_value);
+            break;
+        case uint64_number:
+            handler_->uint64_value(number.uint64_value);
+            break;
+        case not_a_number:
+            assert(false);
+            break;
+        }
+    }
+
+private:
+    Handler_type* handler_;
+};
+
+template<class String_type, class Iter_type, class Handler_type>
+Iter_type read_range_sax_or_throw(Iter_type begin, Iter_type end, Handler_type& handler)
+{
+    Sax_actions<Handler_type, String_type, Iter_type> actions(handler);
+
+    return parse_with_grammar_or_throw(Json_grammar<Sax_actions<Handler_type, String_type, Iter_type>, Iter_type>(actions),
+        begin, end, false);
+}
+
+template<class Char_type, class Handler_type>
+void read_string_sax_or_throw(const std::basic_string<Char_type>& s, Handler_type& handler)
+{
+    typedef std::basic_string<Char_type> String_type;
+
+    const Char_type* const first = s.data();
+    const Char_type* const last = first + s.size();
+
+    Sax_actions<Handler_type, String_type, const Char_type*> actions(handler);
+    simd::Structural_index index;
+
+    parse_contiguous_or_throw(actions, index, first, last, false);
+}
+
+// reads a JSON text from a string calling the handler for each value, e.g.
+//
+// const bool success = read_sax( str, handler );
+//
+template<class Char_type, class Handler_type>
+bool read_sax(const std::basic_string<Char_type>& s, Handler_type& handler)
+{
+    try
+    {
+        read_string_sax_or_throw(s, handler);
+
+        return true;
+    }
+    catch (...)
+    {
+        return false;
+    }
+}
+
+// reads a JSON text from a string calling the handler for each value, throws
+// JsonParseError on invalid input, e.g.
+//
+// read_sax_or_throw( str, handler );
+//
+template<class Char_type, class Handler_type>
+void read_sax_or_throw(const std::basic_string<Char_type>& s, Handler_type& handler)
+{
+    typedef std::basic_string<Char_type> String_type;
+    typedef spirit_namespace::position_iterator<typename String_type::const_iterator> Posn_iter_t;
+
+    try
+    {
+        read_string_sax_or_throw(s, handler);
+    }
+    catch (const std::runtime_error&)
+    {
+        // parse again for the error position like read_string_or_throw(),
+        // the handler has already seen the events so they are not repeated;
+        // if the text is valid the error came from the handler and is kept
+        Null_sax_handler<String_type> null_handler;
+
+        read_range_sax_or_throw<String_type>(Posn_iter_t(s.begin(), s.end()), Posn_iter_t(s.end(), s.end()), null_handler);
+
+        throw;
+    }
+}
+
+// reads a JSON text from a stream calling the handler for each value, e.g.
+//
+// const bool success = read_sax( is, handler );
+//
+template<class Char_type, class Handler_type>
+bool read_sax(std::basic_istream<Char_type>& is, Handler_type& handler)
+{
+    typedef std::basic_istream<Char_type> Istream_type;
+    typedef std::basic_string<Char_type> String_type;
+
+    const Multi_pass_iters<Istream_type> mp_iters(is);
+
+    try
+    {
+        read_range_sax_or_throw<String_type>(mp_iters.begin_, mp_iters.end_, handler);
+
+        return true;
+    }
+    catch (...)
+    {
+        return false;
+    }
+}
+
+// reads a JSON text from a stream calling the handler for each value, throws
+// JsonParseError on invalid input, e.g.
+//
+// read_sax_or_throw( is, handler );
+//
+template<class Char_type, class Handler_type>
+void read_sax_or_throw(std::basic_istream<Char_type>& is, Handler_type& handler)
+{
+    typedef std::basic_istream<Char_type> Istream_type;
+    typedef std::basic_string<Char_type> String_type;
+    typedef Multi_pass_iters<Istream_type> Mp_iters;
+    typedef spirit_namespace::position_iterator<typename Mp_iters::Mp_iter> Posn_iter_t;
+
+    const Mp_iters mp_iters(is);
+
+    read_range_sax_or_throw<String_type>(Posn_iter_t(mp_iters.begin_, mp_iters.end_),
+        Posn_iter_t(mp_iters.end_, mp_iters.end_), handler);
+}
+}
+
+#endif
@@ -0,0 +1,457 @@
+#ifndef JSON_SPIRIT_SIMD
+#define JSON_SPIRIT_SIMD
+
+//          Copyright John W. Wilkinson 2007 - 2014
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+
+// json spirit version 4.08
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+// Block-at-a-time character classification used to speed up reading of narrow
+// (char) input and escaping of the strings written. SSE2 is used when available,
+// AVX2 when the compiler targets it, otherwise portable scalar code gives the same
+// results.
+
+#include <boost/cstdint.hpp>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#if defined(__AVX2__)
+#define JSON_SPIRIT_AVX2
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define JSON_SPIRIT_SSE2
+#endif
+
+#if defined(JSON_SPIRIT_AVX2)
+#include <immintrin.h>
+#elif defined(JSON_SPIRIT_SSE2)
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace json_spirit
+{
+namespace simd
+{
+const std::size_t block_size = 64;
+
+inline int count_trailing_zeros(boost::uint64_t mask)
+{
+    assert(mask != 0);
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index = 0;
+    _BitScanForward64(&index, mask);
+    return static_cast<int>(index);
+#elif defined(_MSC_VER)
+    unsigned long index = 0;
+    if (_BitScanForward(&index, static_cast<unsigned long>(mask)))
+    {
+        return static_cast<int>(index);
+    }
+    _BitScanForward(&index, static_cast<unsigned long>(mask >> 32));
+    return static_cast<int>(index) + 32;
+#else
+    return __builtin_ctzll(mask);
+#endif
+}
+
+// one bit per character of a 64 character block, bit 0 is the first character
+//
+struct Block_masks
+{
+    boost::uint64_t quote; // '"'
+    boost::uint64_t backslash; // '\\'
+    boost::uint64_t space; // white space as defined by is_space_char()
+    boost::uint64_t op; // one of "{}[]:,"
+    boost::uint64_t slash; // '/', starts a comment outside of strings
+    boost::uint64_t hex_x; // 'x' or 'X', starts a hex escape after a backslash
+};
+
+#if defined(JSON_SPIRIT_AVX2)
+
+inline boost::uint64_t to_mask(__m256i lo, __m256i hi)
+{
+    return static_cast<boost::uint32_t>(_mm256_movemask_epi8(lo))
+        | (static_cast<boost::uint64_t>(static_cast<boost::uint32_t>(_mm256_movemask_epi8(hi))) << 32);
+}
+
+inline void classify_block(const char* p, Block_masks& masks)
+{
+    const __m256i in[2] = {
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)),
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32))
+    };
+
+    __m256i quote[2], backslash[2], space[2], op[2], slash[2], hex_x[2];
+
+    for (int i = 0; i < 2; ++i)
+    {
+        const __m256i v = in[i];
+        const __m256i lower = _mm256_or_si256(v, _mm256_set1_epi8(0x20)); // '[' -> '{', ']' -> '}'
+        const __m256i ctrl = _mm256_sub_epi8(v, _mm256_set1_epi8('\t')); // "\t\n\v\f\r" -> 0..4
+
+        quote[i] = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('"'));
+        backslash[i] = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\'));
+        space[i] = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')),
+            _mm256_cmpeq_epi8(_mm256_min_epu8(ctrl, _mm256_set1_epi8(4)), ctrl));
+        op[i] = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(lower, _mm256_set1_epi8('{')), _mm256_cmpeq_epi8(lower, _mm256_set1_epi8('}'))),
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(':')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8(','))));
+        slash[i] = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('/'));
+        hex_x[i] = _mm256_cmpeq_epi8(lower, _mm256_set1_epi8('x'));
+    }
+
+    masks.quote = to_mask(quote[0], quote[1]);
+    masks.backslash = to_mask(backslash[0], backslash[1]);
+    masks.space = to_mask(space[0], space[1]);
+    masks.op = to_mask(op[0], op[1]);
+    masks.slash = to_mask(slash[0], slash[1]);
+    masks.hex_x = to_mask(hex_x[0], hex_x[1]);
+}
+
+#elif defined(JSON_SPIRIT_SSE2)
+
+inline boost::uint64_t to_mask(const __m128i (&v)[4])
+{
+    return static_cast<boost::uint64_t>(_mm_movemask_epi8(v[0]))
+        | (static_cast<boost::uint64_t>(_mm_movemask_epi8(v[1])) << 16)
+        | (static_cast<boost::uint64_t>(_mm_movemask_epi8(v[2])) << 32)
+        | (static_cast<boost::uint64_t>(_mm_movemask_epi8(v[3])) << 48);
+}
+
+inline void classify_block(const char* p, Block_masks& masks)
+{
+    __m128i quote[4], backslash[4], space[4], op[4], slash[4], hex_x[4];
+
+    for (int i = 0; i < 4; ++i)
+    {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * i));
+        const __m128i lower = _mm_or_si128(v, _mm_set1_epi8(0x20)); // '[' -> '{', ']' -> '}'
+        const __m128i ctrl = _mm_sub_epi8(v, _mm_set1_epi8('\t')); // "\t\n\v\f\r" -> 0..4
+
+        quote[i] = _mm_cmpeq_epi8(v, _mm_set1_epi8('"'));
+        backslash[i] = _mm_cmpeq_epi8(v, _mm_set1_epi8('\\'));
+        space[i] = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')),
+            _mm_cmpeq_epi8(_mm_min_epu8(ctrl, _mm_set1_epi8(4)), ctrl));
+        op[i] = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(lower, _mm_set1_epi8('{')), _mm_cmpeq_epi8(lower, _mm_set1_epi8('}'))),
+            _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(':')), _mm_cmpeq_epi8(v, _mm_set1_epi8(','))));
+        slash[i] = _mm_cmpeq_epi8(v, _mm_set1_epi8('/'));
+        hex_x[i] = _mm_cmpeq_epi8(lower, _mm_set1_epi8('x'));
+    }
+
+    masks.quote = to_mask(quote);
+    masks.backslash = to_mask(backslash);
+    masks.space = to_mask(space);
+    masks.op = to_mask(op);
+    masks.slash = to_mask(slash);
+    masks.hex_x = to_mask(hex_x);
+}
+
+#else
+
+inline void classify_block(const char* p, Block_masks& masks)
+{
+    masks = Block_masks();
+
+    for (std::size_t i = 0; i < block_size; ++i)
+    {
+        const boost::uint64_t bit = boost::uint64_t(1) << i;
+
+        switch (p[i])
+        {
+        case '"':
+            masks.quote |= bit;
+            break;
+        case '\\':
+            masks.backslash |= bit;
+            break;
+        case ' ':
+        case '\t':
+        case '\n':
+        case '\v':
+        case '\f':
+        case '\r':
+            masks.space |= bit;
+            break;
+        case '{':
+        case '}':
+        case '[':
+        case ']':
+        case ':':
+        case ',':
+            masks.op |= bit;
+            break;
+        case '/':
+            masks.slash |= bit;
+            break;
+        case 'x':
+        case 'X':
+            masks.hex_x |= bit;
+            break;
+        }
+    }
+}
+
+#endif
+
+// returns the first character in [begin, end) equal to 'a' or 'b', or 'end'
+//
+template<class Char_type>
+const Char_type* find_either(const Char_type* begin, const Char_type* end, Char_type a, Char_type b)
+{
+    for (; begin != end; ++begin)
+    {
+        if (*begin == a || *begin == b)
+        {
+            break;
+        }
+    }
+    return begin;
+}
+
+inline const char* find_either(const char* begin, const char* end, char a, char b)
+{
+#if defined(JSON_SPIRIT_AVX2)
+    const __m256i a_256 = _mm256_set1_epi8(a);
+    const __m256i b_256 = _mm256_set1_epi8(b);
+
+    for (; end - begin >= 32; begin += 32)
+    {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin));
+        const __m256i found = _mm256_or_si256(_mm256_cmpeq_epi8(v, a_256), _mm256_cmpeq_epi8(v, b_256));
+        const boost::uint32_t mask = static_cast<boost::uint32_t>(_mm256_movemask_epi8(found));
+        if (mask != 0)
+        {
+            return begin + count_trailing_zeros(mask);
+        }
+    }
+#endif
+#if defined(JSON_SPIRIT_SSE2)
+    const __m128i a_128 = _mm_set1_epi8(a);
+    const __m128i b_128 = _mm_set1_epi8(b);
+
+    for (; end - begin >= 16; begin += 16)
+    {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+        const __m128i found = _mm_or_si128(_mm_cmpeq_epi8(v, a_128), _mm_cmpeq_epi8(v, b_128));
+        const boost::uint32_t mask = static_cast<boost::uint32_t>(_mm_movemask_epi8(found));
+        if (mask != 0)
+        {
+            return begin + count_trailing_zeros(mask);
+        }
+    }
+#endif
+    return find_either<char>(begin, end, a, b);
+}
+
+// true for the characters that the writer does not copy as they are: '"', '\\', the
+// control characters and, if 'nonascii', DEL and every character beyond ASCII
+//
+template<class Char_type>
+bool is_escape_candidate(Char_type c, bool nonascii)
+{
+    typedef typename std::make_unsigned<Char_type>::type Unsigned_type;
+
+    const Unsigned_type u = static_cast<Unsigned_type>(c);
+
+    return u == '"' || u == '\\' || u < 0x20 || (nonascii && u >= 0x7F);
+}
+
+// returns the first character in [begin, end) for which is_escape_candidate() is
+// true, or 'end'
+//
+template<class Char_type>
+const Char_type* find_escape_candidate(const Char_type* begin, const Char_type* end, bool nonascii)
+{
+    for (; begin != end; ++begin)
+    {
+        if (is_escape_candidate(*begin, nonascii))
+        {
+            break;
+        }
+    }
+    return begin;
+}
+
+inline const char* find_escape_candidate(const char* begin, const char* end, bool nonascii)
+{
+#if defined(JSON_SPIRIT_AVX2)
+    const __m256i quote_256 = _mm256_set1_epi8('"');
+    const __m256i backslash_256 = _mm256_set1_epi8('\\');
+    const __m256i last_control_256 = _mm256_set1_epi8(0x1F);
+    const __m256i del_256 = _mm256_set1_epi8(0x7F);
+
+    for (; end - begin >= 32; begin += 32)
+    {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin));
+        __m256i found = _mm256_or_si256(_mm256_cmpeq_epi8(v, quote_256), _mm256_cmpeq_epi8(v, backslash_256));
+        found = _mm256_or_si256(found, _mm256_cmpeq_epi8(_mm256_max_epu8(v, last_control_256), last_control_256));
+        if (nonascii)
+        {
+            found = _mm256_or_si256(found, _mm256_cmpeq_epi8(_mm256_max_epu8(v, del_256), v));
+        }
+        const boost::uint32_t mask = static_cast<boost::uint32_t>(_mm256_movemask_epi8(found));
+        if (mask != 0)
+        {
+            return begin + count_trailing_zeros(mask);
+        }
+    }
+#endif
+#if defined(JSON_SPIRIT_SSE2)
+    const __m128i quote_128 = _mm_set1_epi8('"');
+    const __m128i backslash_128 = _mm_set1_epi8('\\');
+    const __m128i last_control_128 = _mm_set1_epi8(0x1F);
+    const __m128i del_128 = _mm_set1_epi8(0x7F);
+
+    for (; end - begin >= 16; begin += 16)
+    {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+        __m128i found = _mm_or_si128(_mm_cmpeq_epi8(v, quote_128), _mm_cmpeq_epi8(v, backslash_128));
+        found = _mm_or_si128(found, _mm_cmpeq_epi8(_mm_max_epu8(v, last_control_128), last_control_128));
+        if (nonascii)
+        {
+            found = _mm_or_si128(found, _mm_cmpeq_epi8(_mm_max_epu8(v, del_128), v));
+        }
+        const boost::uint32_t mask = static_cast<boost::uint32_t>(_mm_movemask_epi8(found));
+        if (mask != 0)
+        {
+            return begin + count_trailing_zeros(mask);
+        }
+    }
+#endif
+    return find_escape_candidate<char>(begin, end, nonascii);
+}
+
+// xor of all preceding bits (inclusive) for every bit, turns quote positions into
+// a mask of the string contents including the opening quotes
+//
+inline boost::uint64_t prefix_xor(boost::uint64_t bits)
+{
+    bits ^= bits << 1;
+    bits ^= bits << 2;
+    bits ^= bits << 4;
+    bits ^= bits << 8;
+    bits ^= bits << 16;
+    bits ^= bits << 32;
+    return bits;
+}
+
+// Positions of the tokens of a JSON text: the structural characters "{}[]:,",
+// all unescaped quotes and the first characters of numbers and literals.
+// White space and string contents are not indexed, so a parser walking the index
+// never looks at them.
+//
+class Structural_index
+{
+public:
+    Structural_index()
+    {
+    }
+
+    // returns false if the text can't be indexed, i.e. it is too large, contains comments,
+    // "\x" escapes or an unterminated string, such text is to be scanned character by character
+    //
+    bool build(const char* begin, const char* end)
+    {
+        positions_.clear();
+
+        const std::size_t size = static_cast<std::size_t>(end - begin);
+
+        if (size > 0xFFFFFFFFu)
+        {
+            return false;
+        }
+
+        positions_.reserve(size / 4);
+
+        boost::uint64_t prev_escaped = 0; // 1 if the first character of the next block is escaped
+        boost::uint64_t prev_in_string = 0; // all ones if the next block starts inside a string
+        boost::uint64_t prev_boundary = 1; // 1 if the last character of the previous block ends a token
+
+        for (std::size_t offset = 0; offset < size; offset += block_size)
+        {
+            Block_masks masks;
+
+            if (size - offset >= block_size)
+            {
+                classify_block(begin + offset, masks);
+            }
+            else
+            {
+                char tail[block_size];
+                std::memset(tail, ' ', block_size);
+                std::memcpy(tail, begin + offset, size - offset);
+                classify_block(tail, masks);
+            }
+
+            const boost::uint64_t escaped = find_escaped(masks.backslash, prev_escaped);
+            const boost::uint64_t quote = masks.quote & ~escaped;
+            const boost::uint64_t in_string = prefix_xor(quote) ^ prev_in_string;
+            prev_in_string = static_cast<boost::uint64_t>(static_cast<boost::int64_t>(in_string) >> 63);
+
+            if ((masks.slash & ~in_string) != 0 || (masks.hex_x & escaped) != 0)
+            {
+                return false;
+            }
+
+            const boost::uint64_t op = masks.op & ~in_string;
+            const boost::uint64_t boundary = masks.space | op | quote;
+            const boost::uint64_t scalar_start = ~(boundary | in_string) & ((boundary << 1) | prev_boundary);
+            prev_boundary = boundary >> 63;
+
+            add_positions(static_cast<boost::uint32_t>(offset), op | quote | scalar_start);
+        }
+
+        return prev_in_string == 0;
+    }
+
+    const std::vector<boost::uint32_t>& positions() const { return positions_; }
+
+private:
+    // backslash sequences of odd length escape the next character, this tells which
+    // characters are escaped without looking at backslashes one by one
+    //
+    static boost::uint64_t find_escaped(boost::uint64_t backslash, boost::uint64_t& prev_escaped)
+    {
+        const boost::uint64_t even_bits = 0x5555555555555555ULL;
+
+        backslash &= ~prev_escaped;
+
+        const boost::uint64_t follows_escape = (backslash << 1) | prev_escaped;
+        const boost::uint64_t odd_sequence_starts = backslash & ~even_bits & ~follows_escape;
+        const boost::uint64_t sequences_starting_on_even_bits = odd_sequence_starts + backslash;
+
+        prev_escaped = (sequences_starting_on_even_bits < odd_sequence_starts) ? 1 : 0;
+
+        const boost::uint64_t invert_mask = sequences_starting_on_even_bits << 1;
+
+        return (even_bits ^ invert_mask) & follows_escape;
+    }
+
+    void add_positions(boost::uint32_t offset, boost::uint64_t bits)
+    {
+        while (bits != 0)
+        {
+            positions_.push_back(offset + static_cast<boost::uint32_t>(count_trailing_zeros(bits)));
+            bits &= bits - 1;
+        }
+    }
+
+    std::vector<boost::uint32_t> positions_;
+};
+}
+}
+
+#endif
@@ -0,0 +1,508 @@
+#ifndef JSON_SPIRIT_STRING_POOL
+#define JSON_SPIRIT_STRING_POOL
+
+//          Copyright John W. Wilkinson 2007 - 2014
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+
+// json spirit version 4.08
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+namespace json_spirit
+{
+template<class Char_type>
+class String_pool;
+
+namespace internal_
+{
+// the characters of an Interned_string follow its node, shared by all its copies
+//
+template<class Char_type>
+struct Interned_node
+{
+    std::atomic<std::size_t> refs_;
+    std::size_t size_;
+    std::size_t hash_;
+    const String_pool<Char_type>* pool_; // null for strings too long to share
+
+    const Char_type* chars() const
+    {
+        return reinterpret_cast<const Char_type*>(this + 1);
+    }
+
+    Char_type* chars()
+    {
+        return reinterpret_cast<Char_type*>(this + 1);
+    }
+};
+
+// FNV-1a, names are short so this is as quick as anything fancier
+//
+template<class Char_type>
+std::size_t hash_chars(const Char_type* s, std::size_t size)
+{
+    std::size_t hash = sizeof(std::size_t) == 8 ? static_cast<std::size_t>(14695981039346656037ULL) : 2166136261U;
+    const std::size_t prime = sizeof(std::size_t) == 8 ? static_cast<std::size_t>(1099511628211ULL) : 16777619U;
+
+    for (std::size_t i = 0; i != size; ++i)
+    {
+        hash = (hash ^ static_cast<std::size_t>(s[i])) * prime;
+    }
+
+    return hash;
+}
+}
+
+// An Interned_string is an immutable string whose characters are shared by all its copies,
+// and, when it was created by a String_pool, by every other string of the pool with the
+// same characters. So a document repeating a name a million times holds one copy of it,
+// and copying or comparing two strings of the same pool does not look at the characters.
+//
+// It is a single pointer, values store it inline, see Is_interned. The strings created
+// from characters, e.g. by the reader, are interned in String_pool::shared().
+//
+template<class Char_type>
+class Interned_string
+{
+public:
+    typedef Char_type value_type;
+    typedef std::char_traits<Char_type> traits_type;
+    typedef std::size_t size_type;
+    typedef const Char_type* const_iterator;
+    typedef const_iterator iterator;
+
+    Interned_string() noexcept
+        : node_(nullptr)
+    {
+    }
+
+    Interned_string(const Char_type* s);
+    Interned_string(const Char_type* s, std::size_t size);
+    Interned_string(const std::basic_string<Char_type>& s);
+
+    Interned_string(const Interned_string& other) noexcept
+        : node_(other.node_)
+    {
+        if (node_ != nullptr)
+        {
+            node_->refs_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    Interned_string(Interned_string&& other) noexcept
+        : node_(other.node_)
+    {
+        other.node_ = nullptr;
+    }
+
+    ~Interned_string()
+    {
+        release();
+    }
+
+    Interned_string& operator=(const Interned_string& other) noexcept
+    {
+        Interned_string(other).swap(*this);
+
+        return *this;
+    }
+
+    Interned_string& operator=(Interned_string&& other) noexcept
+    {
+        Interned_string(std::move(other)).swap(*this);
+
+        return *this;
+    }
+
+    void swap(Interned_string& other) noexcept
+    {
+        std::swap(node_, other.node_);
+    }
+
+    void clear() noexcept
+    {
+        release();
+        node_ = nullptr;
+    }
+
+    const Char_type* data() const
+    {
+        static const Char_type empty_chars[1] = {};
+
+        return node_ != nullptr ? node_->chars() : empty_chars;
+    }
+
+    const Char_type* c_str() const
+    {
+        return data();
+    }
+
+    std::size_t size() const
+    {
+        return node_ != nullptr ? node_->size_ : 0;
+    }
+
+    std::size_t length() const
+    {
+        return size();
+    }
+
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+    const_iterator begin() const
+    {
+        return data();
+    }
+
+    const_iterator end() const
+    {
+        return data() + size();
+    }
+
+    Char_type operator[](std::size_t i) const
+    {
+        return data()[i];
+    }
+
+    std::size_t hash() const
+    {
+        return node_ != nullptr ? node_->hash_ : internal_::hash_chars<Char_type>(nullptr, 0);
+    }
+
+    std::basic_string<Char_type> str() const
+    {
+        return std::basic_string<Char_type>(data(), size());
+    }
+
+    friend bool operator==(const Interned_string& lhs, const Interned_string& rhs)
+    {
+        if (lhs.node_ == rhs.node_)
+        {
+            return true;
+        }
+
+        if (lhs.node_ != nullptr && rhs.node_ != nullptr && lhs.node_->pool_ != nullptr && lhs.node_->pool_ == rhs.node_->pool_)
+        {
+            return false; // a pool holds each string once
+        }
+
+        return compare(lhs, rhs.data(), rhs.size()) == 0;
+    }
+
+    friend bool operator==(const Interned_string& lhs, const Char_type* rhs)
+    {
+        return compare(lhs, rhs, traits_type::length(rhs)) == 0;
+    }
+
+    friend bool operator==(const Char_type* lhs, const Interned_string& rhs)
+    {
+        return rhs == lhs;
+    }
+
+    friend bool operator==(const Interned_string& lhs, const std::basic_string<Char_type>& rhs)
+    {
+        return compare(lhs, rhs.data(), rhs.size()) == 0;
+    }
+
+    friend bool operator==(const std::basic_string<Char_type>& lhs, const Interned_string& rhs)
+    {
+        return rhs == lhs;
+    }
+
+    template<class T>
+    friend bool operator!=(const Interned_string& lhs, const T& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    friend bool operator<(const Interned_string& lhs, const Interned_string& rhs)
+    {
+        return compare(lhs, rhs.data(), rhs.size()) < 0;
+    }
+
+    friend std::basic_ostream<Char_type>& operator<<(std::basic_ostream<Char_type>& os, const Interned_string& s)
+    {
+        return os.write(s.data(), static_cast<std::streamsize>(s.size()));
+    }
+
+private:
+    typedef internal_::Interned_node<Char_type> Node;
+
+    friend class String_pool<Char_type>;
+
+    // adopts a reference to the node
+    //
+    explicit Interned_string(Node* node) noexcept
+        : node_(node)
+    {
+    }
+
+    static int compare(const Interned_string& lhs, const Char_type* s, std::size_t size)
+    {
+        const int result = traits_type::compare(lhs.data(), s, std::min(lhs.size(), size));
+
+        if (result != 0)
+        {
+            return result;
+        }
+
+        return lhs.size() < size ? -1 : (lhs.size() > size ? 1 : 0);
+    }
+
+    // strings of a pool are freed by String_pool::collect() once unreferenced, as
+    // another thread could be finding them in the pool; the node is not touched after
+    // the count is dropped, as collect() may free it at once
+    //
+    void release() noexcept
+    {
+        if (node_ == nullptr)
+        {
+            return;
+        }
+
+        const bool pooled = node_->pool_ != nullptr; // never changes
+
+        if (node_->refs_.fetch_sub(1, std::memory_order_acq_rel) == 1 && !pooled)
+        {
+            String_pool<Char_type>::destroy(node_);
+        }
+    }
+
+    Node* node_;
+};
+
+// A String_pool holds one copy of each of the strings interned in it, to be shared by all
+// the Interned_strings with the same characters. Strings longer than max_interned_size
+// are rarely repeated, e.g. a text rather than a name or a status code, so they are not
+// kept in the pool but still shared by their copies.
+//
+// Any number of threads can intern strings in a pool at once, the strings are spread over
+// independently locked shards. The strings no longer referenced are freed by collect(),
+// which a shard also does by itself whenever it has doubled in size.
+//
+// A pool must outlive its strings, the shared pool is never destroyed.
+//
+template<class Char_type>
+class String_pool
+{
+public:
+    static const std::size_t max_interned_size = 64;
+
+    String_pool()
+    {
+    }
+
+    ~String_pool()
+    {
+        for (Shard& shard : shards_)
+        {
+            for (auto& entry : shard.nodes_)
+            {
+                assert(entry.second->refs_.load() == 0);
+
+                destroy(entry.second);
+            }
+        }
+    }
+
+    // the pool of the strings read into values, e.g. by read_string()
+    //
+    static String_pool& shared()
+    {
+        static String_pool* const pool = new String_pool;
+
+        return *pool;
+    }
+
+    Interned_string<Char_type> intern(const Char_type* s, std::size_t size)
+    {
+        const std::size_t hash = internal_::hash_chars(s, size);
+
+        if (size > max_interned_size)
+        {
+            return Interned_string<Char_type>(create(s, size, hash, nullptr));
+        }
+
+        Shard& shard = shards_[(hash >> 8) % shard_count];
+
+        std::lock_guard<std::mutex> lock(shard.mutex_);
+
+        const auto range = shard.nodes_.equal_range(hash);
+
+        for (auto i = range.first; i != range.second; ++i)
+        {
+            Node* const node = i->second;
+
+            if (node->size_ == size && std::char_traits<Char_type>::compare(node->chars(), s, size) == 0)
+            {
+                node->refs_.fetch_add(1, std::memory_order_relaxed);
+
+                return Interned_string<Char_type>(node);
+            }
+        }
+
+        if (shard.nodes_.size() >= shard.collect_size_)
+        {
+            collect(shard);
+
+            shard.collect_size_ = std::max(std::size_t(min_collect_size), 2 * shard.nodes_.size());
+        }
+
+        Node* const node = create(s, size, hash, this);
+
+        shard.nodes_.emplace(hash, node);
+
+        return Interned_string<Char_type>(node);
+    }
+
+    // frees the strings no longer referenced, returns how many there were
+    //
+    std::size_t collect()
+    {
+        std::size_t count = 0;
+
+        for (Shard& shard : shards_)
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex_);
+
+            count += collect(shard);
+        }
+
+        return count;
+    }
+
+    // the number of strings held, including those that collect() would free
+    //
+    std::size_t size() const
+    {
+        std::size_t count = 0;
+
+        for (const Shard& shard : shards_)
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex_);
+
+            count += shard.nodes_.size();
+        }
+
+        return count;
+    }
+
+private:
+    typedef internal_::Interned_node<Char_type> Node;
+
+    friend class Interned_string<Char_type>;
+
+    static const std::size_t shard_count = 16;
+    static const std::size_t min_collect_size = 256;
+
+    struct Shard
+    {
+        Shard()
+            : collect_size_(min_collect_size)
+        {
+        }
+
+        mutable std::mutex mutex_;
+        std::unordered_multimap<std::size_t, Node*> nodes_; // by hash
+        std::size_t collect_size_;
+    };
+
+    String_pool(const String_pool&);
+    String_pool& operator=(const String_pool&);
+
+    static Node* create(const Char_type* s, std::size_t size, std::size_t hash, const String_pool* pool)
+    {
+        Node* const node = new (::operator new(sizeof(Node) + (size + 1) * sizeof(Char_type))) Node;
+
+        node->refs_.store(1, std::memory_order_relaxed);
+        node->size_ = size;
+        node->hash_ = hash;
+        node->pool_ = pool;
+        std::char_traits<Char_type>::copy(node->chars(), s, size);
+        node->chars()[size] = Char_type();
+
+        return node;
+    }
+
+    static void destroy(Node* node) noexcept
+    {
+        node->~Node();
+        ::operator delete(node);
+    }
+
+    // a string only gains a reference from zero in intern(), under the lock held here
+    //
+    static std::size_t collect(Shard& shard)
+    {
+        std::size_t count = 0;
+
+        for (auto i = shard.nodes_.begin(); i != shard.nodes_.end();)
+        {
+            if (i->second->refs_.load(std::memory_order_acquire) == 0)
+            {
+                destroy(i->second);
+                i = shard.nodes_.erase(i);
+                ++count;
+            }
+            else
+            {
+                ++i;
+            }
+        }
+
+        return count;
+    }
+
+    Shard shards_[shard_count];
+};
+
+template<class Char_type>
+Interned_string<Char_type>::Interned_string(const Char_type* s)
+    : Interned_string(String_pool<Char_type>::shared().intern(s, traits_type::length(s)))
+{
+}
+
+template<class Char_type>
+Interned_string<Char_type>::Interned_string(const Char_type* s, std::size_t size)
+    : Interned_string(String_pool<Char_type>::shared().intern(s, size))
+{
+}
+
+template<class Char_type>
+Interned_string<Char_type>::Interned_string(const std::basic_string<Char_type>& s)
+    : Interned_string(String_pool<Char_type>::shared().intern(s.data(), s.size()))
+{
+}
+
+// true for string types that values store in place of the pointer to their string,
+// which requires them to be a pointer in size and movable by copying their bytes
+//
+template<class String_type>
+struct Is_interned : std::false_type
+{
+};
+
+template<class Char_type>
+struct Is_interned<Interned_string<Char_type>> : std::true_type
+{
+};
+}
+
+#endif
@@ -0,0 +1,106 @@
+#ifndef JSON_SPIRIT_UTF8
+#define JSON_SPIRIT_UTF8
+
+//          Copyright John W. Wilkinson 2007 - 2014
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+
+// json spirit version 4.08
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+// Decodes the UTF-8 held in narrow strings, so that the generator can pass valid
+// sequences through or escape them as code points, see Generator::output().
+//
+// Only well-formed sequences as defined by the Unicode standard are decoded, overlong
+// forms, surrogates and code points beyond U+10FFFF are rejected.
+
+#include <boost/cstdint.hpp>
+#include <cstddef>
+
+namespace json_spirit
+{
+namespace utf8
+{
+// the length of the sequence started by each byte, 0 for bytes that cannot start one,
+// i.e. continuation bytes, the leads of overlong 2 byte forms and the leads beyond U+10FFFF
+//
+template<class Dummy = void>
+struct Sequence_lengths
+{
+    static const unsigned char table[256];
+};
+
+template<class Dummy>
+const unsigned char Sequence_lengths<Dummy>::table[256] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // 00..1F
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // 20..3F
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // 40..5F
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // 60..7F
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 80..9F
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // A0..BF
+    0, 0, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, // C0..DF
+    3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 // E0..FF
+};
+
+// the leads of 3 and 4 byte sequences that allow only part of the continuation bytes
+// after them, to rule out overlong forms, surrogates and code points beyond U+10FFFF
+//
+inline bool is_valid_second_byte(unsigned char lead, unsigned char second)
+{
+    switch (lead)
+    {
+    case 0xE0:
+        return second >= 0xA0;
+    case 0xED:
+        return second < 0xA0;
+    case 0xF0:
+        return second >= 0x90;
+    case 0xF4:
+        return second < 0x90;
+    }
+
+    return true;
+}
+
+// decodes the sequence starting at 'begin', returns its length or 0 if it is not
+// well-formed or not complete before 'end'
+//
+inline std::size_t decode(const char* begin, const char* end, boost::uint32_t& code_point)
+{
+    const unsigned char* const s = reinterpret_cast<const unsigned char*>(begin);
+    const std::size_t length = Sequence_lengths<>::table[s[0]];
+
+    if (length == 1)
+    {
+        code_point = s[0];
+
+        return 1;
+    }
+
+    if (length == 0 || static_cast<std::size_t>(end - begin) < length || !is_valid_second_byte(s[0], s[1]))
+    {
+        return 0;
+    }
+
+    boost::uint32_t result = s[0] & (0x7F >> length);
+
+    for (std::size_t i = 1; i != length; ++i)
+    {
+        if ((s[i] & 0xC0) != 0x80)
+        {
+            return 0;
+        }
+
+        result = (result << 6) | (s[i] & 0x3F);
+    }
+
+    code_point = result;
+
+    return length;
+}
+}
+}
+
+#endif
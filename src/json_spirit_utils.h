@@ -58,6 +58,22 @@ const typename Object_type::value_type::Value_type& find_value(const Object_type
 
     return Object_type::value_type::Value_type::null;
 }
+
+template<class Pair_type, class Allocator, class String_type>
+const typename Pair_type::Value_type& find_value(const Vector_object<Pair_type, Allocator>& obj, const String_type& name)
+{
+    const auto i = obj.find(name);
+
+    return i != obj.end() ? i->value_ : Pair_type::Value_type::null;
+}
+
+template<class Pair_type, class Allocator, class Hash, class String_type>
+const typename Pair_type::Value_type& find_value(const Hash_object<Pair_type, Allocator, Hash>& obj, const String_type& name)
+{
+    const auto i = obj.find(name);
+
+    return i != obj.end() ? i->value_ : Pair_type::Value_type::null;
+}
 }
 
 #endif
@@ -10,16 +10,24 @@
 #pragma once
 #endif
 
+#include "json_spirit_hash_object.h"
+#include "json_spirit_string_pool.h"
 #include <boost/config.hpp>
+#include <boost/container/small_vector.hpp>
 #include <boost/cstdint.hpp>
 #include <boost/numeric/conversion/cast.hpp>
 #include <boost/shared_ptr.hpp>
+#include <boost/utility/string_ref.hpp>
 #include <boost/variant.hpp>
+#include <atomic>
 #include <cassert>
 #include <map>
+#include <memory>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 // comment out the value types you don't need to reduce build times and intermediate file sizes
@@ -27,6 +35,18 @@
 #define JSON_SPIRIT_WVALUE_ENABLED
 #define JSON_SPIRIT_MVALUE_ENABLED
 #define JSON_SPIRIT_WMVALUE_ENABLED
+#define JSON_SPIRIT_HVALUE_ENABLED
+#define JSON_SPIRIT_WHVALUE_ENABLED
+
+// values whose strings and containers use a std::pmr::memory_resource are available to C++17 callers
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+#if defined(__has_include)
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#define JSON_SPIRIT_STD_PMR
+#endif
+#endif
+#endif
 
 namespace json_spirit
 {
@@ -46,8 +66,136 @@ struct Null
 {
 };
 
+// how copies of a value hold its object or array, a Config chooses one as its Copy_policy
+//
+// With Deep_copy every copy owns a whole copy of the tree below it. With Copy_on_write
+// copies share their objects and arrays, which are only copied, one level at a time, when
+// a copy is changed through get_obj() or get_array(). So passing a document by value
+// costs one increment, however large it is.
+//
+struct Deep_copy
+{
+};
+
+struct Copy_on_write
+{
+};
+
+namespace internal_
+{
+// true for strings and containers with an allocator, see Value_impl::create()
+//
+template<class T, class = void>
+struct Has_allocator : std::false_type
+{
+};
+
+template<class T>
+struct Has_allocator<T, std::conditional_t<true, void, typename T::allocator_type>> : std::true_type
+{
+};
+
+// true for Configs whose values share their objects and arrays, see Copy_on_write
+//
+template<class Config, class = void>
+struct Is_copy_on_write : std::false_type
+{
+};
+
+template<class Config>
+struct Is_copy_on_write<Config, std::conditional_t<true, void, typename Config::Copy_policy>>
+    : std::is_same<typename Config::Copy_policy, Copy_on_write>
+{
+};
+
+// an object or array shared by copy on write values, it is a T so the values
+// point to it as to an unshared one
+//
+template<class T>
+struct Shared_container : T
+{
+    explicit Shared_container(T&& value)
+        : T(std::move(value))
+        , refs_(1)
+    {
+    }
+
+    std::atomic<std::size_t> refs_;
+};
+
+// an array of numbers of one type stored without their values, see Value_impl::get_int64_array()
+//
+// The array of values that get_array() returns for it is only created when first asked for,
+// by any number of threads at once, so reading the numbers directly costs nothing more.
+//
+template<class T, class Array>
+class Packed_array
+{
+public:
+    explicit Packed_array(std::vector<T>&& values)
+        : values_(std::move(values))
+        , array_(nullptr)
+    {
+    }
+
+    Packed_array(const Packed_array& other)
+        : values_(other.values_)
+        , array_(nullptr)
+    {
+    }
+
+    Packed_array(Packed_array&& other) noexcept
+        : values_(std::move(other.values_))
+        , array_(other.array_.exchange(nullptr, std::memory_order_relaxed))
+    {
+    }
+
+    ~Packed_array()
+    {
+        delete array_.load(std::memory_order_relaxed);
+    }
+
+    const std::vector<T>& values() const
+    {
+        return values_;
+    }
+
+    const Array& array() const
+    {
+        const Array* array = array_.load(std::memory_order_acquire);
+
+        if (array == nullptr)
+        {
+            std::unique_ptr<Array> created(new Array(values_.begin(), values_.end()));
+
+            if (array_.compare_exchange_strong(array, created.get(), std::memory_order_acq_rel, std::memory_order_acquire))
+            {
+                array = created.release();
+            }
+        }
+
+        return *array;
+    }
+
+    bool operator==(const Packed_array& other) const
+    {
+        return values_ == other.values_;
+    }
+
+private:
+    Packed_array& operator=(const Packed_array&);
+
+    std::vector<T> values_;
+    mutable std::atomic<const Array*> array_;
+};
+}
+
 template<class Config> // Config determines whether the value uses std::string or std::wstring and
 // whether JSON Objects are represented as vectors or maps
+//
+// A value is a tagged node of two words: numbers and booleans are stored inline, strings,
+// objects and arrays are owned through a pointer. So a container of values is compact and
+// moving a value never allocates.
 class Value_impl
 {
 public:
@@ -55,13 +203,20 @@ public:
     typedef typename Config::String_type String_type;
     typedef typename Config::Object_type Object;
     typedef typename Config::Array_type Array;
-    typedef typename String_type::const_pointer Const_str_ptr; // eg const char*
+    typedef const typename String_type::value_type* Const_str_ptr; // eg const char*
 
     Value_impl(); // creates null value
     Value_impl(Const_str_ptr value);
     Value_impl(const String_type& value);
+    Value_impl(String_type&& value);
     Value_impl(const Object& value);
+    Value_impl(Object&& value);
     Value_impl(const Array& value);
+    Value_impl(Array&& value);
+    Value_impl(const std::vector<boost::int64_t>& values); // creates a packed array, see get_int64_array()
+    Value_impl(std::vector<boost::int64_t>&& values);
+    Value_impl(const std::vector<double>& values); // creates a packed array, see get_real_array()
+    Value_impl(std::vector<double>&& values);
     Value_impl(bool value);
 
     template<typename IntT>
@@ -70,8 +225,9 @@ public:
             std::is_integral<IntT>::value
             && std::is_signed<IntT>::value
             && !std::is_same<IntT, bool>::value>* = nullptr)
-        : v_(static_cast<boost::int64_t>(value))
+        : tag_(int64_tag)
     {
+        payload_.int64_ = value;
     }
 
     template<typename UintT>
@@ -80,16 +236,18 @@ public:
             std::is_integral<UintT>::value
             && std::is_unsigned<UintT>::value
             && !std::is_same<UintT, bool>::value>* = nullptr)
-        : v_(static_cast<boost::uint64_t>(value))
+        : tag_(uint64_tag)
     {
+        payload_.uint64_ = value;
     }
 
     template<typename IntT>
     Value_impl(IntT value,
         std::enable_if_t<
             std::is_floating_point<IntT>::value>* = nullptr)
-        : v_(static_cast<double>(value))
+        : tag_(double_tag)
     {
+        payload_.double_ = value;
     }
 
     template<class Iter>
@@ -100,15 +258,24 @@ public:
 
     Value_impl(const Value_impl& other);
 
+    // moving only transfers ownership of the string, object or array,
+    // so containers of values grow without copying whole subtrees
+    Value_impl(Value_impl&& other) noexcept;
+
+    ~Value_impl();
+
     bool operator==(const Value_impl& lhs) const;
 
     Value_impl& operator=(const Value_impl& lhs);
+    Value_impl& operator=(Value_impl&& lhs) noexcept;
 
     Value_type type() const;
 
     bool is_int64() const;
     bool is_uint64() const;
     bool is_null() const;
+    bool is_int64_array() const;
+    bool is_real_array() const;
 
     const String_type& get_str() const;
     const Object& get_obj() const;
@@ -118,9 +285,19 @@ public:
     boost::uint64_t get_uint64() const;
     double get_real() const;
 
+    // with a Copy_on_write Config these first copy the object or array if it is shared,
+    // the reference must not be kept once the value has been copied again
     Object& get_obj();
     Array& get_array();
 
+    // the numbers of a packed array, i.e. one read with the pack_numeric_arrays option or
+    // created from a vector of numbers, its type is array_type
+    //
+    // get_array() also works on a packed array: the const version creates the array of values
+    // once, alongside the numbers, the other one replaces the numbers by the values.
+    const std::vector<boost::int64_t>& get_int64_array() const;
+    const std::vector<double>& get_real_array() const;
+
     template<typename T>
     T get_value() const; // example usage: int    i = value.get_value< int >();
         // or             double d = value.get_value< double >();
@@ -129,124 +306,146 @@ public:
 
 private:
     void check_type(const Value_type vtype) const;
+    void swap(Value_impl& other) noexcept;
 
-    using Variant = boost::variant<boost::recursive_wrapper<Object>, boost::recursive_wrapper<Array>,
-        String_type, bool, double, Null, boost::uint64_t, boost::int64_t>;
+    // the string, object or array of a value is allocated with its own allocator,
+    // so with a memory resource the whole value lives in that resource
+    template<class T>
+    static T* create(T&& value);
 
-    enum : int
-    {
-        type_index_object,
-        type_index_array,
-        type_index_sting,
-        type_index_bool,
-        type_index_double,
-        type_index_null,
-        type_index_uint64,
-        type_index_int64,
-    };
+    template<class T>
+    static T* create(T&& value, std::true_type /* has allocator */);
 
-    Variant v_;
+    template<class T>
+    static T* create(T&& value, std::false_type /* has allocator */);
 
-    template<class NumberT>
-    struct AssignNumber
-    {
-    };
+    template<class T>
+    static void destroy(T* p) noexcept;
 
-    struct GetInt64Visitor : public boost::static_visitor<boost::int64_t>
-    {
-        boost::int64_t operator()(boost::int64_t value) const
-        {
-            return value;
-        }
+    template<class T>
+    static void destroy(T* p, std::true_type /* has allocator */) noexcept;
 
-        boost::int64_t operator()(boost::uint64_t value) const
-        {
-            return boost::numeric_cast<boost::int64_t>(value);
-        }
+    template<class T>
+    static void destroy(T* p, std::false_type /* has allocator */) noexcept;
 
-        boost::int64_t operator()(double value) const
-        {
-            return boost::numeric_cast<boost::int64_t>(value);
-        }
+    // objects and arrays are shared between the copies of copy on write values
+    typedef std::integral_constant<bool, internal_::Is_copy_on_write<Config>::value> Shared_containers;
 
-        template<class T>
-        boost::int64_t operator()(const T&) const
-        {
-            throw std::logic_error("bad number value");
-        }
-    };
+    template<class T>
+    static T* create_container(T&& value);
 
-    struct GetUint64Visitor : public boost::static_visitor<boost::uint64_t>
-    {
-        boost::uint64_t operator()(boost::int64_t value) const
-        {
-            return boost::numeric_cast<boost::uint64_t>(value);
-        }
+    template<class T>
+    static T* create_container(T&& value, std::true_type /* shared */);
 
-        boost::uint64_t operator()(boost::uint64_t value) const
-        {
-            return value;
-        }
+    template<class T>
+    static T* create_container(T&& value, std::false_type /* shared */);
 
-        boost::uint64_t operator()(double value) const
-        {
-            return boost::numeric_cast<boost::uint64_t>(value);
-        }
+    template<class T>
+    static T* copy_container(T* p);
 
-        template<class T>
-        boost::uint64_t operator()(const T&) const
-        {
-            throw std::logic_error("bad number value");
-        }
-    };
+    template<class T>
+    static T* copy_container(T* p, std::true_type /* shared */);
 
-    struct GetRealVisitor : public boost::static_visitor<double>
-    {
-        double operator()(boost::int64_t value) const
-        {
-            return static_cast<double>(value);
-        }
+    template<class T>
+    static T* copy_container(T* p, std::false_type /* shared */);
 
-        double operator()(boost::uint64_t value) const
-        {
-            return static_cast<double>(value);
-        }
+    template<class T>
+    static void destroy_container(T* p) noexcept;
 
-        double operator()(double value) const
-        {
-            return value;
-        }
+    template<class T>
+    static void destroy_container(T* p, std::true_type /* shared */) noexcept;
 
-        template<class T>
-        double operator()(const T&) const
-        {
-            throw std::logic_error("bad number value");
-        }
+    template<class T>
+    static void destroy_container(T* p, std::false_type /* shared */) noexcept;
+
+    template<class T>
+    static T& unshare_container(T*& p);
+
+    template<class T>
+    static T& unshare_container(T*& p, std::true_type /* shared */);
+
+    template<class T>
+    static T& unshare_container(T*& p, std::false_type /* shared */);
+
+    typedef internal_::Packed_array<boost::int64_t, Array> Int64_array;
+    typedef internal_::Packed_array<double, Array> Real_array;
+
+    template<class Packed>
+    Array& unpack_array(Packed* packed);
+
+    void check_packed_type(bool is_packed, const char* packed_type) const;
+
+    // interned strings are a pointer themselves, so they are stored in the payload
+    // rather than allocated, see Is_interned
+    typedef std::integral_constant<bool, Is_interned<String_type>::value> Inline_str;
+
+    void set_str(String_type&& value);
+    void set_str(String_type&& value, std::true_type /* inline */);
+    void set_str(String_type&& value, std::false_type /* inline */);
+
+    const String_type& str() const;
+    const String_type& str(std::true_type /* inline */) const;
+    const String_type& str(std::false_type /* inline */) const;
+
+    void destroy_str() noexcept;
+    void destroy_str(std::true_type /* inline */) noexcept;
+    void destroy_str(std::false_type /* inline */) noexcept;
+
+    enum Tag : unsigned char
+    {
+        null_tag,
+        bool_tag,
+        int64_tag,
+        uint64_tag,
+        double_tag,
+        str_tag,
+        obj_tag,
+        array_tag,
+        int64_array_tag,
+        double_array_tag,
+    };
+
+    union Payload
+    {
+        bool bool_;
+        boost::int64_t int64_;
+        boost::uint64_t uint64_;
+        double double_;
+        String_type* str_;
+        typename std::aligned_storage<sizeof(void*), alignof(void*)>::type inline_str_;
+        Object* obj_;
+        Array* array_;
+        Int64_array* int64_array_;
+        Real_array* double_array_;
     };
 
-    class Variant_converter_visitor : public boost::static_visitor<Variant>
+    Payload payload_;
+    Tag tag_;
+
+    class Variant_converter_visitor : public boost::static_visitor<Value_impl>
     {
     public:
         template<typename T, typename A, template<typename, typename> class Cont>
-        Variant operator()(const Cont<T, A>& cont) const
+        Value_impl operator()(const Cont<T, A>& cont) const
         {
             return Array(cont.begin(), cont.end());
         }
 
-        Variant operator()(int i) const
+        Value_impl operator()(int i) const
         {
             return static_cast<boost::int64_t>(i);
         }
 
         template<class T>
-        Variant operator()(const T& t) const
+        Value_impl operator()(const T& t) const
         {
             return t;
         }
     };
 };
 
-// vector objects
+// vector objects, large ones are indexed when searched, see Vector_object in json_spirit_hash_object.h;
+// an Object is no longer a std::vector<Pair> itself, use Object::pairs() where one is needed
 
 template<class Config>
 struct Pair_impl
@@ -259,6 +458,7 @@ struct Pair_impl
     }
 
     Pair_impl(const String_type& name, const Value_type& value);
+    Pair_impl(String_type&& name, Value_type&& value);
 
     bool operator==(const Pair_impl& lhs) const;
 
@@ -267,20 +467,24 @@ struct Pair_impl
 };
 
 #if defined(JSON_SPIRIT_VALUE_ENABLED) || defined(JSON_SPIRIT_WVALUE_ENABLED)
-template<class String>
+template<class String, class Copy = Deep_copy>
 struct Config_vector
 {
     typedef String String_type;
+    typedef Copy Copy_policy;
     typedef Value_impl<Config_vector> Value_type;
     typedef Pair_impl<Config_vector> Pair_type;
     typedef std::vector<Value_type> Array_type;
-    typedef std::vector<Pair_type> Object_type;
+    typedef Vector_object<Pair_type> Object_type;
 
     static Value_type& add(Object_type& obj, const String_type& name, const Value_type& value)
     {
-        obj.push_back(Pair_type(name, value));
+        return obj.emplace_back(name, value).value_;
+    }
 
-        return obj.back().value_;
+    static Value_type& add(Object_type& obj, String_type&& name, Value_type&& value)
+    {
+        return obj.emplace_back(std::move(name), std::move(value)).value_;
     }
 
     static const String_type& get_name(const Pair_type& pair)
@@ -317,13 +521,37 @@ typedef wConfig::Object_type wObject;
 typedef wConfig::Array_type wArray;
 #endif
 
+// typedefs for values read in situ, see read_in_situ() in json_spirit_reader.h
+//
+// The strings and names of these values are views of the buffer they were read from,
+// so the buffer must outlive them. They cannot be written.
+
+#ifdef JSON_SPIRIT_VALUE_ENABLED
+typedef Config_vector<boost::string_ref> vConfig;
+
+typedef vConfig::Value_type vValue;
+typedef vConfig::Pair_type vPair;
+typedef vConfig::Object_type vObject;
+typedef vConfig::Array_type vArray;
+#endif
+
+#if defined(JSON_SPIRIT_WVALUE_ENABLED) && !defined(BOOST_NO_STD_WSTRING)
+typedef Config_vector<boost::wstring_ref> wvConfig;
+
+typedef wvConfig::Value_type wvValue;
+typedef wvConfig::Pair_type wvPair;
+typedef wvConfig::Object_type wvObject;
+typedef wvConfig::Array_type wvArray;
+#endif
+
 // map objects
 
 #if defined(JSON_SPIRIT_MVALUE_ENABLED) || defined(JSON_SPIRIT_WMVALUE_ENABLED)
-template<class String>
+template<class String, class Copy = Deep_copy>
 struct Config_map
 {
     typedef String String_type;
+    typedef Copy Copy_policy;
     typedef Value_impl<Config_map> Value_type;
     typedef std::vector<Value_type> Array_type;
     typedef std::map<String_type, Value_type> Object_type;
@@ -334,6 +562,11 @@ struct Config_map
         return obj[name] = value;
     }
 
+    static Value_type& add(Object_type& obj, String_type&& name, Value_type&& value)
+    {
+        return obj[std::move(name)] = std::move(value);
+    }
+
     static const String_type& get_name(const Pair_type& pair)
     {
         return pair.first;
@@ -366,132 +599,783 @@ typedef wmConfig::Object_type wmObject;
 typedef wmConfig::Array_type wmArray;
 #endif
 
-///////////////////////////////////////////////////////////////////////////////////////////////
+// typedefs for values with interned strings, see json_spirit_string_pool.h
 //
-// implementation
+// The names and strings read into these values are shared with all the other values
+// holding the same text, so many similar documents take little more memory than one.
 
-inline bool operator==(const Null&, const Null&)
-{
-    return true;
-}
+#ifdef JSON_SPIRIT_VALUE_ENABLED
+typedef Config_vector<Interned_string<char>> iConfig;
 
-template<class Config>
-const Value_impl<Config> Value_impl<Config>::null;
+typedef iConfig::Value_type iValue;
+typedef iConfig::Pair_type iPair;
+typedef iConfig::Object_type iObject;
+typedef iConfig::Array_type iArray;
+#endif
 
-template<class Config>
-Value_impl<Config>::Value_impl()
-    : v_(Null())
-{
-}
+#if defined(JSON_SPIRIT_WVALUE_ENABLED) && !defined(BOOST_NO_STD_WSTRING)
+typedef Config_vector<Interned_string<wchar_t>> wiConfig;
 
-template<class Config>
-Value_impl<Config>::Value_impl(const Const_str_ptr value)
-    : v_(String_type(value))
-{
-}
+typedef wiConfig::Value_type wiValue;
+typedef wiConfig::Pair_type wiPair;
+typedef wiConfig::Object_type wiObject;
+typedef wiConfig::Array_type wiArray;
+#endif
 
-template<class Config>
-Value_impl<Config>::Value_impl(const String_type& value)
-    : v_(value)
-{
-}
+#ifdef JSON_SPIRIT_MVALUE_ENABLED
+typedef Config_map<Interned_string<char>> imConfig;
 
-template<class Config>
-Value_impl<Config>::Value_impl(const Object& value)
-    : v_(value)
-{
-}
+typedef imConfig::Value_type imValue;
+typedef imConfig::Object_type imObject;
+typedef imConfig::Array_type imArray;
+#endif
 
-template<class Config>
-Value_impl<Config>::Value_impl(const Array& value)
-    : v_(value)
-{
-}
+#if defined(JSON_SPIRIT_WMVALUE_ENABLED) && !defined(BOOST_NO_STD_WSTRING)
+typedef Config_map<Interned_string<wchar_t>> wimConfig;
 
-template<class Config>
-Value_impl<Config>::Value_impl(bool value)
-    : v_(value)
-{
-}
+typedef wimConfig::Value_type wimValue;
+typedef wimConfig::Object_type wimObject;
+typedef wimConfig::Array_type wimArray;
+#endif
 
-template<class Config>
-Value_impl<Config>::Value_impl(const Value_impl<Config>& other)
-    : v_(other.v_)
-{
-}
+// hash indexed objects, ordered like vector objects but found by name like map objects,
+// see json_spirit_hash_object.h
 
-template<class Config>
-template<class Iter>
-Value_impl<Config>::Value_impl(Iter first, Iter last)
-    : v_(Array(first, last))
+#if defined(JSON_SPIRIT_HVALUE_ENABLED) || defined(JSON_SPIRIT_WHVALUE_ENABLED)
+template<class String, class Copy = Deep_copy>
+struct Config_hash
 {
-}
+    typedef String String_type;
+    typedef Copy Copy_policy;
+    typedef Value_impl<Config_hash> Value_type;
+    typedef Pair_impl<Config_hash> Pair_type;
+    typedef std::vector<Value_type> Array_type;
+    typedef Hash_object<Pair_type> Object_type;
 
-template<class Config>
-template<BOOST_VARIANT_ENUM_PARAMS(typename T)>
-Value_impl<Config>::Value_impl(const boost::variant<BOOST_VARIANT_ENUM_PARAMS(T)>& variant)
-    : v_(boost::apply_visitor(Variant_converter_visitor(), variant))
-{
-}
+    static Value_type& add(Object_type& obj, const String_type& name, const Value_type& value)
+    {
+        return obj.insert_or_assign(name, value).first->value_;
+    }
 
-template<class Config>
-Value_impl<Config>& Value_impl<Config>::operator=(const Value_impl& lhs)
-{
-    Value_impl tmp(lhs);
+    static Value_type& add(Object_type& obj, String_type&& name, Value_type&& value)
+    {
+        return obj.insert_or_assign(std::move(name), std::move(value)).first->value_;
+    }
 
-    std::swap(v_, tmp.v_);
+    static const String_type& get_name(const Pair_type& pair)
+    {
+        return pair.name_;
+    }
 
-    return *this;
-}
+    static const Value_type& get_value(const Pair_type& pair)
+    {
+        return pair.value_;
+    }
+};
+#endif
 
-template<class Config>
-bool Value_impl<Config>::operator==(const Value_impl& lhs) const
-{
-    if (this == &lhs)
-        return true;
+// typedefs for ASCII
 
-    if (type() != lhs.type())
-        return false;
+#ifdef JSON_SPIRIT_HVALUE_ENABLED
+typedef Config_hash<std::string> hConfig;
 
-    return v_ == lhs.v_;
-}
+typedef hConfig::Value_type hValue;
+typedef hConfig::Pair_type hPair;
+typedef hConfig::Object_type hObject;
+typedef hConfig::Array_type hArray;
+#endif
 
-template<class Config>
-Value_type Value_impl<Config>::type() const
+// typedefs for Unicode
+
+#if defined(JSON_SPIRIT_WHVALUE_ENABLED) && !defined(BOOST_NO_STD_WSTRING)
+typedef Config_hash<std::wstring> whConfig;
+
+typedef whConfig::Value_type whValue;
+typedef whConfig::Pair_type whPair;
+typedef whConfig::Object_type whObject;
+typedef whConfig::Array_type whArray;
+#endif
+
+// small vector objects and arrays, which hold their first few pairs or values in place
+//
+// Most objects and arrays of messages are small, e.g. a point or a name and an id, so with
+// these each one is allocated once, together with its pairs or values, rather than twice.
+// A larger one holds its pairs or values in a separate buffer, as a vector does.
+
+#if defined(JSON_SPIRIT_VALUE_ENABLED) || defined(JSON_SPIRIT_WVALUE_ENABLED)
+template<class String, std::size_t Object_capacity = 4, std::size_t Array_capacity = 4>
+struct Config_small
 {
-    switch (v_.which())
+    typedef String String_type;
+    typedef Value_impl<Config_small> Value_type;
+    typedef Pair_impl<Config_small> Pair_type;
+    typedef boost::container::small_vector<Value_type, Array_capacity> Array_type;
+    typedef boost::container::small_vector<Pair_type, Object_capacity> Object_type;
+
+    static Value_type& add(Object_type& obj, const String_type& name, const Value_type& value)
     {
-    default:
-        BOOST_FALLTHROUGH;
-    case type_index_null:
-        return null_type;
-    case type_index_object:
-        return obj_type;
-    case type_index_array:
-        return array_type;
-    case type_index_sting:
-        return str_type;
-    case type_index_bool:
-        return bool_type;
-    case type_index_double:
-        BOOST_FALLTHROUGH;
-    case type_index_int64:
-        BOOST_FALLTHROUGH;
-    case type_index_uint64:
-        return number_type;
+        return obj.emplace_back(name, value).value_;
     }
-}
 
-template<class Config>
-bool Value_impl<Config>::is_int64() const
-{
-    return v_.which() == type_index_int64;
+    static Value_type& add(Object_type& obj, String_type&& name, Value_type&& value)
+    {
+        return obj.emplace_back(std::move(name), std::move(value)).value_;
+    }
+
+    static const String_type& get_name(const Pair_type& pair)
+    {
+        return pair.name_;
+    }
+
+    static const Value_type& get_value(const Pair_type& pair)
+    {
+        return pair.value_;
+    }
+};
+#endif
+
+#ifdef JSON_SPIRIT_VALUE_ENABLED
+typedef Config_small<std::string> cConfig;
+
+typedef cConfig::Value_type cValue;
+typedef cConfig::Pair_type cPair;
+typedef cConfig::Object_type cObject;
+typedef cConfig::Array_type cArray;
+#endif
+
+#if defined(JSON_SPIRIT_WVALUE_ENABLED) && !defined(BOOST_NO_STD_WSTRING)
+typedef Config_small<std::wstring> wcConfig;
+
+typedef wcConfig::Value_type wcValue;
+typedef wcConfig::Pair_type wcPair;
+typedef wcConfig::Object_type wcObject;
+typedef wcConfig::Array_type wcArray;
+#endif
+
+// typedefs for copy on write values, see Copy_on_write
+//
+// Copies of these values share their objects and arrays until they are changed, so
+// documents can be passed and cached by value.
+
+#ifdef JSON_SPIRIT_VALUE_ENABLED
+typedef Config_vector<std::string, Copy_on_write> sConfig;
+
+typedef sConfig::Value_type sValue;
+typedef sConfig::Pair_type sPair;
+typedef sConfig::Object_type sObject;
+typedef sConfig::Array_type sArray;
+#endif
+
+#if defined(JSON_SPIRIT_WVALUE_ENABLED) && !defined(BOOST_NO_STD_WSTRING)
+typedef Config_vector<std::wstring, Copy_on_write> wsConfig;
+
+typedef wsConfig::Value_type wsValue;
+typedef wsConfig::Pair_type wsPair;
+typedef wsConfig::Object_type wsObject;
+typedef wsConfig::Array_type wsArray;
+#endif
+
+#ifdef JSON_SPIRIT_MVALUE_ENABLED
+typedef Config_map<std::string, Copy_on_write> smConfig;
+
+typedef smConfig::Value_type smValue;
+typedef smConfig::Object_type smObject;
+typedef smConfig::Array_type smArray;
+#endif
+
+#if defined(JSON_SPIRIT_WMVALUE_ENABLED) && !defined(BOOST_NO_STD_WSTRING)
+typedef Config_map<std::wstring, Copy_on_write> wsmConfig;
+
+typedef wsmConfig::Value_type wsmValue;
+typedef wsmConfig::Object_type wsmObject;
+typedef wsmConfig::Array_type wsmArray;
+#endif
+
+// allocator aware objects
+//
+// The strings, objects and arrays of these values are allocated from a std::pmr::memory_resource,
+// e.g. a monotonic_buffer_resource holding a whole document, see read_string() in
+// json_spirit_reader_template.h. Copies use the default resource, as usual for pmr containers.
+
+#ifdef JSON_SPIRIT_STD_PMR
+template<class String>
+struct Config_vector_pmr
+{
+    typedef String String_type;
+    typedef Value_impl<Config_vector_pmr> Value_type;
+    typedef Pair_impl<Config_vector_pmr> Pair_type;
+    typedef std::pmr::vector<Value_type> Array_type;
+    typedef std::pmr::vector<Pair_type> Object_type;
+
+    static Value_type& add(Object_type& obj, const String_type& name, const Value_type& value)
+    {
+        obj.push_back(Pair_type(name, value));
+
+        return obj.back().value_;
+    }
+
+    static Value_type& add(Object_type& obj, String_type&& name, Value_type&& value)
+    {
+        obj.emplace_back(std::move(name), std::move(value));
+
+        return obj.back().value_;
+    }
+
+    static const String_type& get_name(const Pair_type& pair)
+    {
+        return pair.name_;
+    }
+
+    static const Value_type& get_value(const Pair_type& pair)
+    {
+        return pair.value_;
+    }
+};
+
+template<class String>
+struct Config_map_pmr
+{
+    typedef String String_type;
+    typedef Value_impl<Config_map_pmr> Value_type;
+    typedef std::pmr::vector<Value_type> Array_type;
+    typedef std::pmr::map<String_type, Value_type> Object_type;
+    typedef std::pair<const String_type, Value_type> Pair_type;
+
+    static Value_type& add(Object_type& obj, const String_type& name, const Value_type& value)
+    {
+        return obj[name] = value;
+    }
+
+    static Value_type& add(Object_type& obj, String_type&& name, Value_type&& value)
+    {
+        return obj[std::move(name)] = std::move(value);
+    }
+
+    static const String_type& get_name(const Pair_type& pair)
+    {
+        return pair.first;
+    }
+
+    static const Value_type& get_value(const Pair_type& pair)
+    {
+        return pair.second;
+    }
+};
+
+typedef Config_vector_pmr<std::pmr::string> Config_pmr;
+
+typedef Config_pmr::Value_type Value_pmr;
+typedef Config_pmr::Pair_type Pair_pmr;
+typedef Config_pmr::Object_type Object_pmr;
+typedef Config_pmr::Array_type Array_pmr;
+
+typedef Config_map_pmr<std::pmr::string> mConfig_pmr;
+
+typedef mConfig_pmr::Value_type mValue_pmr;
+typedef mConfig_pmr::Object_type mObject_pmr;
+typedef mConfig_pmr::Array_type mArray_pmr;
+#endif
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// implementation
+
+inline bool operator==(const Null&, const Null&)
+{
+    return true;
+}
+
+template<class Config>
+const Value_impl<Config> Value_impl<Config>::null;
+
+template<class Config>
+Value_impl<Config>::Value_impl()
+    : tag_(null_tag)
+{
+    payload_.int64_ = 0;
+}
+
+template<class Config>
+Value_impl<Config>::Value_impl(const Const_str_ptr value)
+    : tag_(str_tag)
+{
+    set_str(String_type(value));
+}
+
+template<class Config>
+Value_impl<Config>::Value_impl(const String_type& value)
+    : tag_(str_tag)
+{
+    set_str(String_type(value));
+}
+
+template<class Config>
+Value_impl<Config>::Value_impl(String_type&& value)
+    : tag_(str_tag)
+{
+    set_str(std::move(value));
+}
+
+template<class Config>
+Value_impl<Config>::Value_impl(const Object& value)
+    : tag_(obj_tag)
+{
+    payload_.obj_ = create_container(Object(value));
+}
+
+template<class Config>
+Value_impl<Config>::Value_impl(Object&& value)
+    : tag_(obj_tag)
+{
+    payload_.obj_ = create_container(std::move(value));
+}
+
+template<class Config>
+Value_impl<Config>::Value_impl(const Array& value)
+    : tag_(array_tag)
+{
+    payload_.array_ = create_container(Array(value));
+}
+
+template<class Config>
+Value_impl<Config>::Value_impl(Array&& value)
+    : tag_(array_tag)
+{
+    payload_.array_ = create_container(std::move(value));
+}
+
+template<class Config>
+Value_impl<Config>::Value_impl(const std::vector<boost::int64_t>& values)
+    : tag_(int64_array_tag)
+{
+    payload_.int64_array_ = create_container(Int64_array(std::vector<boost::int64_t>(values)));
+}
+
+template<class Config>
+Value_impl<Config>::Value_impl(std::vector<boost::int64_t>&& values)
+    : tag_(int64_array_tag)
+{
+    payload_.int64_array_ = create_container(Int64_array(std::move(values)));
+}
+
+template<class Config>
+Value_impl<Config>::Value_impl(const std::vector<double>& values)
+    : tag_(double_array_tag)
+{
+    payload_.double_array_ = create_container(Real_array(std::vector<double>(values)));
+}
+
+template<class Config>
+Value_impl<Config>::Value_impl(std::vector<double>&& values)
+    : tag_(double_array_tag)
+{
+    payload_.double_array_ = create_container(Real_array(std::move(values)));
+}
+
+template<class Config>
+Value_impl<Config>::Value_impl(bool value)
+    : tag_(bool_tag)
+{
+    payload_.int64_ = 0;
+    payload_.bool_ = value;
+}
+
+template<class Config>
+Value_impl<Config>::Value_impl(const Value_impl<Config>& other)
+    : payload_(other.payload_)
+    , tag_(other.tag_)
+{
+    switch (tag_)
+    {
+    case str_tag:
+        set_str(String_type(other.str()));
+        break;
+    case obj_tag:
+        payload_.obj_ = copy_container(other.payload_.obj_);
+        break;
+    case array_tag:
+        payload_.array_ = copy_container(other.payload_.array_);
+        break;
+    case int64_array_tag:
+        payload_.int64_array_ = copy_container(other.payload_.int64_array_);
+        break;
+    case double_array_tag:
+        payload_.double_array_ = copy_container(other.payload_.double_array_);
+        break;
+    default:
+        break;
+    }
+}
+
+template<class Config>
+Value_impl<Config>::Value_impl(Value_impl<Config>&& other) noexcept
+    : payload_(other.payload_)
+    , tag_(other.tag_)
+{
+    other.tag_ = null_tag;
+}
+
+template<class Config>
+Value_impl<Config>::~Value_impl()
+{
+    switch (tag_)
+    {
+    case str_tag:
+        destroy_str();
+        break;
+    case obj_tag:
+        destroy_container(payload_.obj_);
+        break;
+    case array_tag:
+        destroy_container(payload_.array_);
+        break;
+    case int64_array_tag:
+        destroy_container(payload_.int64_array_);
+        break;
+    case double_array_tag:
+        destroy_container(payload_.double_array_);
+        break;
+    default:
+        break;
+    }
+}
+
+template<class Config>
+template<class Iter>
+Value_impl<Config>::Value_impl(Iter first, Iter last)
+    : tag_(array_tag)
+{
+    payload_.array_ = create_container(Array(first, last));
+}
+
+template<class Config>
+template<BOOST_VARIANT_ENUM_PARAMS(typename T)>
+Value_impl<Config>::Value_impl(const boost::variant<BOOST_VARIANT_ENUM_PARAMS(T)>& variant)
+    : Value_impl(boost::apply_visitor(Variant_converter_visitor(), variant))
+{
+}
+
+template<class Config>
+template<class T>
+T* Value_impl<Config>::create(T&& value)
+{
+    return create(std::move(value), internal_::Has_allocator<T>());
+}
+
+template<class Config>
+template<class T>
+T* Value_impl<Config>::create(T&& value, std::true_type /* has allocator */)
+{
+    typedef typename std::allocator_traits<typename T::allocator_type>::template rebind_alloc<T> Allocator_type;
+    typedef std::allocator_traits<Allocator_type> Traits;
+
+    Allocator_type allocator(value.get_allocator());
+    T* const p = Traits::allocate(allocator, 1);
+
+    try
+    {
+        return ::new (static_cast<void*>(p)) T(std::move(value));
+    }
+    catch (...)
+    {
+        Traits::deallocate(allocator, p, 1);
+        throw;
+    }
+}
+
+template<class Config>
+template<class T>
+T* Value_impl<Config>::create(T&& value, std::false_type /* has allocator */)
+{
+    return new T(std::move(value));
+}
+
+template<class Config>
+template<class T>
+void Value_impl<Config>::destroy(T* p) noexcept
+{
+    destroy(p, internal_::Has_allocator<T>());
+}
+
+template<class Config>
+template<class T>
+void Value_impl<Config>::destroy(T* p, std::true_type /* has allocator */) noexcept
+{
+    typedef typename std::allocator_traits<typename T::allocator_type>::template rebind_alloc<T> Allocator_type;
+
+    Allocator_type allocator(p->get_allocator());
+    p->~T();
+    std::allocator_traits<Allocator_type>::deallocate(allocator, p, 1);
+}
+
+template<class Config>
+template<class T>
+void Value_impl<Config>::destroy(T* p, std::false_type /* has allocator */) noexcept
+{
+    delete p;
+}
+
+template<class Config>
+template<class T>
+T* Value_impl<Config>::create_container(T&& value)
+{
+    return create_container(std::move(value), Shared_containers());
+}
+
+template<class Config>
+template<class T>
+T* Value_impl<Config>::create_container(T&& value, std::true_type /* shared */)
+{
+    return new internal_::Shared_container<T>(std::move(value));
+}
+
+template<class Config>
+template<class T>
+T* Value_impl<Config>::create_container(T&& value, std::false_type /* shared */)
+{
+    return create(std::move(value));
+}
+
+template<class Config>
+template<class T>
+T* Value_impl<Config>::copy_container(T* p)
+{
+    return copy_container(p, Shared_containers());
+}
+
+template<class Config>
+template<class T>
+T* Value_impl<Config>::copy_container(T* p, std::true_type /* shared */)
+{
+    static_cast<internal_::Shared_container<T>*>(p)->refs_.fetch_add(1, std::memory_order_relaxed);
+
+    return p;
+}
+
+template<class Config>
+template<class T>
+T* Value_impl<Config>::copy_container(T* p, std::false_type /* shared */)
+{
+    return create(T(*p));
+}
+
+template<class Config>
+template<class T>
+void Value_impl<Config>::destroy_container(T* p) noexcept
+{
+    destroy_container(p, Shared_containers());
+}
+
+template<class Config>
+template<class T>
+void Value_impl<Config>::destroy_container(T* p, std::true_type /* shared */) noexcept
+{
+    internal_::Shared_container<T>* const shared = static_cast<internal_::Shared_container<T>*>(p);
+
+    if (shared->refs_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        delete shared;
+    }
+}
+
+template<class Config>
+template<class T>
+void Value_impl<Config>::destroy_container(T* p, std::false_type /* shared */) noexcept
+{
+    destroy(p);
+}
+
+template<class Config>
+template<class T>
+T& Value_impl<Config>::unshare_container(T*& p)
+{
+    return unshare_container(p, Shared_containers());
+}
+
+// copying the container only copies the values it holds, which share their own containers
+//
+template<class Config>
+template<class T>
+T& Value_impl<Config>::unshare_container(T*& p, std::true_type /* shared */)
+{
+    if (static_cast<internal_::Shared_container<T>*>(p)->refs_.load(std::memory_order_acquire) != 1)
+    {
+        T* const copy = create_container(T(*p));
+
+        destroy_container(p);
+        p = copy;
+    }
+
+    return *p;
+}
+
+template<class Config>
+template<class T>
+T& Value_impl<Config>::unshare_container(T*& p, std::false_type /* shared */)
+{
+    return *p;
+}
+
+template<class Config>
+void Value_impl<Config>::set_str(String_type&& value)
+{
+    set_str(std::move(value), Inline_str());
+}
+
+template<class Config>
+void Value_impl<Config>::set_str(String_type&& value, std::true_type /* inline */)
+{
+    static_assert(sizeof(String_type) <= sizeof(payload_.inline_str_), "an inline string must fit the payload");
+
+    new (&payload_.inline_str_) String_type(std::move(value));
+}
+
+template<class Config>
+void Value_impl<Config>::set_str(String_type&& value, std::false_type /* inline */)
+{
+    payload_.str_ = create(std::move(value));
+}
+
+template<class Config>
+const typename Config::String_type& Value_impl<Config>::str() const
+{
+    return str(Inline_str());
+}
+
+template<class Config>
+const typename Config::String_type& Value_impl<Config>::str(std::true_type /* inline */) const
+{
+    return *reinterpret_cast<const String_type*>(&payload_.inline_str_);
+}
+
+template<class Config>
+const typename Config::String_type& Value_impl<Config>::str(std::false_type /* inline */) const
+{
+    return *payload_.str_;
+}
+
+template<class Config>
+void Value_impl<Config>::destroy_str() noexcept
+{
+    destroy_str(Inline_str());
+}
+
+template<class Config>
+void Value_impl<Config>::destroy_str(std::true_type /* inline */) noexcept
+{
+    reinterpret_cast<String_type*>(&payload_.inline_str_)->~String_type();
+}
+
+template<class Config>
+void Value_impl<Config>::destroy_str(std::false_type /* inline */) noexcept
+{
+    destroy(payload_.str_);
+}
+
+template<class Config>
+void Value_impl<Config>::swap(Value_impl& other) noexcept
+{
+    std::swap(payload_, other.payload_);
+    std::swap(tag_, other.tag_);
+}
+
+template<class Config>
+Value_impl<Config>& Value_impl<Config>::operator=(const Value_impl& lhs)
+{
+    Value_impl tmp(lhs);
+
+    swap(tmp);
+
+    return *this;
+}
+
+template<class Config>
+Value_impl<Config>& Value_impl<Config>::operator=(Value_impl&& lhs) noexcept
+{
+    Value_impl tmp(std::move(lhs));
+
+    swap(tmp);
+
+    return *this;
+}
+
+template<class Config>
+bool Value_impl<Config>::operator==(const Value_impl& lhs) const
+{
+    if (this == &lhs)
+        return true;
+
+    if (tag_ != lhs.tag_)
+    {
+        // a packed array equals the array of its values
+        return type() == array_type && lhs.type() == array_type && get_array() == lhs.get_array();
+    }
+
+    switch (tag_)
+    {
+    case bool_tag:
+        return payload_.bool_ == lhs.payload_.bool_;
+    case int64_tag:
+        return payload_.int64_ == lhs.payload_.int64_;
+    case uint64_tag:
+        return payload_.uint64_ == lhs.payload_.uint64_;
+    case double_tag:
+        return payload_.double_ == lhs.payload_.double_;
+    case str_tag:
+        return str() == lhs.str();
+    case obj_tag:
+        return payload_.obj_ == lhs.payload_.obj_ || *payload_.obj_ == *lhs.payload_.obj_;
+    case array_tag:
+        return payload_.array_ == lhs.payload_.array_ || *payload_.array_ == *lhs.payload_.array_;
+    case int64_array_tag:
+        return *payload_.int64_array_ == *lhs.payload_.int64_array_;
+    case double_array_tag:
+        return *payload_.double_array_ == *lhs.payload_.double_array_;
+    default:
+        return true;
+    }
+}
+
+template<class Config>
+Value_type Value_impl<Config>::type() const
+{
+    switch (tag_)
+    {
+    default:
+        BOOST_FALLTHROUGH;
+    case null_tag:
+        return null_type;
+    case obj_tag:
+        return obj_type;
+    case array_tag:
+        BOOST_FALLTHROUGH;
+    case int64_array_tag:
+        BOOST_FALLTHROUGH;
+    case double_array_tag:
+        return array_type;
+    case str_tag:
+        return str_type;
+    case bool_tag:
+        return bool_type;
+    case double_tag:
+        BOOST_FALLTHROUGH;
+    case int64_tag:
+        BOOST_FALLTHROUGH;
+    case uint64_tag:
+        return number_type;
+    }
+}
+
+template<class Config>
+bool Value_impl<Config>::is_int64() const
+{
+    return tag_ == int64_tag;
 }
 
 template<class Config>
 bool Value_impl<Config>::is_uint64() const
 {
-    return v_.which() == type_index_uint64;
+    return tag_ == uint64_tag;
 }
 
 template<class Config>
@@ -500,6 +1384,18 @@ bool Value_impl<Config>::is_null() const
     return type() == null_type;
 }
 
+template<class Config>
+bool Value_impl<Config>::is_int64_array() const
+{
+    return tag_ == int64_array_tag;
+}
+
+template<class Config>
+bool Value_impl<Config>::is_real_array() const
+{
+    return tag_ == double_array_tag;
+}
+
 template<class Config>
 void Value_impl<Config>::check_type(const Value_type vtype) const
 {
@@ -520,7 +1416,7 @@ const typename Config::String_type& Value_impl<Config>::get_str() const
 {
     check_type(str_type);
 
-    return *boost::get<String_type>(&v_);
+    return str();
 }
 
 template<class Config>
@@ -528,7 +1424,7 @@ const typename Value_impl<Config>::Object& Value_impl<Config>::get_obj() const
 {
     check_type(obj_type);
 
-    return *boost::get<Object>(&v_);
+    return *payload_.obj_;
 }
 
 template<class Config>
@@ -536,7 +1432,46 @@ const typename Value_impl<Config>::Array& Value_impl<Config>::get_array() const
 {
     check_type(array_type);
 
-    return *boost::get<Array>(&v_);
+    switch (tag_)
+    {
+    case int64_array_tag:
+        return payload_.int64_array_->array();
+    case double_array_tag:
+        return payload_.double_array_->array();
+    default:
+        return *payload_.array_;
+    }
+}
+
+template<class Config>
+void Value_impl<Config>::check_packed_type(bool is_packed, const char* packed_type) const
+{
+    if (!is_packed)
+    {
+        std::string reason;
+        reason.append("get_")
+            .append(packed_type)
+            .append("_array called on ")
+            .append(value_type_to_string(type()))
+            .append(" value");
+        throw std::runtime_error(reason);
+    }
+}
+
+template<class Config>
+const std::vector<boost::int64_t>& Value_impl<Config>::get_int64_array() const
+{
+    check_packed_type(is_int64_array(), "int64");
+
+    return payload_.int64_array_->values();
+}
+
+template<class Config>
+const std::vector<double>& Value_impl<Config>::get_real_array() const
+{
+    check_packed_type(is_real_array(), "real");
+
+    return payload_.double_array_->values();
 }
 
 template<class Config>
@@ -544,31 +1479,55 @@ bool Value_impl<Config>::get_bool() const
 {
     check_type(bool_type);
 
-    return boost::get<bool>(v_);
+    return payload_.bool_;
 }
 
 template<class Config>
 boost::int64_t Value_impl<Config>::get_int64() const
 {
     check_type(number_type);
-    GetInt64Visitor visitor;
-    return v_.apply_visitor(visitor);
+
+    switch (tag_)
+    {
+    case uint64_tag:
+        return boost::numeric_cast<boost::int64_t>(payload_.uint64_);
+    case double_tag:
+        return boost::numeric_cast<boost::int64_t>(payload_.double_);
+    default:
+        return payload_.int64_;
+    }
 }
 
 template<class Config>
 boost::uint64_t Value_impl<Config>::get_uint64() const
 {
     check_type(number_type);
-    GetUint64Visitor visitor;
-    return v_.apply_visitor(visitor);
+
+    switch (tag_)
+    {
+    case int64_tag:
+        return boost::numeric_cast<boost::uint64_t>(payload_.int64_);
+    case double_tag:
+        return boost::numeric_cast<boost::uint64_t>(payload_.double_);
+    default:
+        return payload_.uint64_;
+    }
 }
 
 template<class Config>
 double Value_impl<Config>::get_real() const
 {
     check_type(number_type);
-    GetRealVisitor visitor;
-    return v_.apply_visitor(visitor);
+
+    switch (tag_)
+    {
+    case int64_tag:
+        return static_cast<double>(payload_.int64_);
+    case uint64_tag:
+        return static_cast<double>(payload_.uint64_);
+    default:
+        return payload_.double_;
+    }
 }
 
 template<class Config>
@@ -576,7 +1535,7 @@ typename Value_impl<Config>::Object& Value_impl<Config>::get_obj()
 {
     check_type(obj_type);
 
-    return *boost::get<Object>(&v_);
+    return unshare_container(payload_.obj_);
 }
 
 template<class Config>
@@ -584,7 +1543,28 @@ typename Value_impl<Config>::Array& Value_impl<Config>::get_array()
 {
     check_type(array_type);
 
-    return *boost::get<Array>(&v_);
+    switch (tag_)
+    {
+    case int64_array_tag:
+        return unpack_array(payload_.int64_array_);
+    case double_array_tag:
+        return unpack_array(payload_.double_array_);
+    default:
+        return unshare_container(payload_.array_);
+    }
+}
+
+template<class Config>
+template<class Packed>
+typename Value_impl<Config>::Array& Value_impl<Config>::unpack_array(Packed* packed)
+{
+    Array* const array = create_container(Array(packed->values().begin(), packed->values().end()));
+
+    destroy_container(packed);
+    payload_.array_ = array;
+    tag_ = array_tag;
+
+    return *array;
 }
 
 template<class Config>
@@ -594,6 +1574,13 @@ Pair_impl<Config>::Pair_impl(const String_type& name, const Value_type& value)
 {
 }
 
+template<class Config>
+Pair_impl<Config>::Pair_impl(String_type&& name, Value_type&& value)
+    : name_(std::move(name))
+    , value_(std::move(value))
+{
+}
+
 template<class Config>
 bool Pair_impl<Config>::operator==(const Pair_impl<Config>& lhs) const
 {
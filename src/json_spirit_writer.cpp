@@ -94,3 +94,47 @@ std::wstring json_spirit::write(const wmValue& value, int options)
     return write_string(value, options);
 }
 #endif
+
+#ifdef JSON_SPIRIT_HVALUE_ENABLED
+void json_spirit::write(const hValue& value, std::ostream& os, int options)
+{
+    write_stream(value, os, options);
+}
+
+std::string json_spirit::write(const hValue& value, int options)
+{
+    return write_string(value, options);
+}
+
+void json_spirit::write_formatted(const hValue& value, std::ostream& os)
+{
+    write_stream(value, os, pretty_print);
+}
+
+std::string json_spirit::write_formatted(const hValue& value)
+{
+    return write_string(value, pretty_print);
+}
+#endif
+
+#if defined(JSON_SPIRIT_WHVALUE_ENABLED) && !defined(BOOST_NO_STD_WSTRING)
+void json_spirit::write_formatted(const whValue& value, std::wostream& os)
+{
+    write_stream(value, os, pretty_print);
+}
+
+std::wstring json_spirit::write_formatted(const whValue& value)
+{
+    return write_string(value, pretty_print);
+}
+
+void json_spirit::write(const whValue& value, std::wostream& os, int options)
+{
+    write_stream(value, os, options);
+}
+
+std::wstring json_spirit::write(const whValue& value, int options)
+{
+    return write_string(value, options);
+}
+#endif
@@ -17,8 +17,8 @@
 namespace json_spirit
 {
 // these functions to convert JSON Values to text
-// note the precision used outputing doubles defaults to 17,
-// unless the remove_trailing_zeros option is given in which case the default is 16
+// note doubles are written with the fewest digits that read back as the same double,
+// see format_double() in json_spirit_number_formatter.h
 
 #ifdef JSON_SPIRIT_VALUE_ENABLED
 void write(const Value& value, std::ostream& os, int options = none);
@@ -40,6 +40,16 @@ void write(const wmValue& value, std::wostream& os, int options = none);
 std::wstring write(const wmValue& value, int options = none);
 #endif
 
+#ifdef JSON_SPIRIT_HVALUE_ENABLED
+void write(const hValue& value, std::ostream& os, int options = none);
+std::string write(const hValue& value, int options = none);
+#endif
+
+#if defined(JSON_SPIRIT_WHVALUE_ENABLED) && !defined(BOOST_NO_STD_WSTRING)
+void write(const whValue& value, std::wostream& os, int options = none);
+std::wstring write(const whValue& value, int options = none);
+#endif
+
 // these "formatted" versions of the "write" functions are the equivalent of the above functions
 // with option "pretty_print"
 
@@ -60,6 +70,15 @@ std::wstring write_formatted(const wValue& value);
 void write_formatted(const wmValue& value, std::wostream& os);
 std::wstring write_formatted(const wmValue& value);
 #endif
+
+#ifdef JSON_SPIRIT_HVALUE_ENABLED
+void write_formatted(const hValue& value, std::ostream& os);
+std::string write_formatted(const hValue& value);
+#endif
+#if defined(JSON_SPIRIT_WHVALUE_ENABLED) && !defined(BOOST_NO_STD_WSTRING)
+void write_formatted(const whValue& value, std::wostream& os);
+std::wstring write_formatted(const whValue& value);
+#endif
 }
 
 #endif
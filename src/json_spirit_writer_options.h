@@ -32,7 +32,9 @@ enum Output_options
 
     always_escape_nonascii = 0x10,
     // all unicode wide characters are escaped, i.e. outputed as "\uXXXX", even if they are
-    // printable under the current locale, ascii printable chars are not escaped
+    // printable under the current locale, ascii printable chars are not escaped.
+    // UTF-8 sequences in 8 bit char strings are escaped as the characters they encode,
+    // using surrogate pairs beyond U+FFFF; without this option they pass through unaltered.
 };
 }
 
@@ -10,13 +10,18 @@
 #pragma once
 #endif
 
+#include "json_spirit_number_formatter.h"
+#include "json_spirit_output_sinks.h"
+#include "json_spirit_simd.h"
+#include "json_spirit_utf8.h"
 #include "json_spirit_value.h"
 #include "json_spirit_writer_options.h"
 
-#include <boost/io/ios_state.hpp>
+#include <algorithm>
 #include <cassert>
-#include <iomanip>
-#include <sstream>
+#include <cwctype>
+#include <string>
+#include <type_traits>
 
 namespace json_spirit
 {
@@ -32,167 +37,12 @@ inline char to_hex_char(unsigned int c)
     return 'A' - 10 + ch;
 }
 
-template<class String_type>
-String_type non_printable_to_string(unsigned int c)
-{
-    String_type result(6, '\\');
-
-    result[1] = 'u';
-
-    result[5] = to_hex_char(c & 0x000F);
-    c >>= 4;
-    result[4] = to_hex_char(c & 0x000F);
-    c >>= 4;
-    result[3] = to_hex_char(c & 0x000F);
-    c >>= 4;
-    result[2] = to_hex_char(c & 0x000F);
-
-    return result;
-}
-
-template<typename Char_type, class String_type>
-bool add_esc_char(Char_type c, String_type& s)
-{
-    switch (c)
-    {
-    case '"':
-        s += to_str<String_type>("\\\"");
-        return true;
-    case '\\':
-        s += to_str<String_type>("\\\\");
-        return true;
-    case '\b':
-        s += to_str<String_type>("\\b");
-        return true;
-    case '\f':
-        s += to_str<String_type>("\\f");
-        return true;
-    case '\n':
-        s += to_str<String_type>("\\n");
-        return true;
-    case '\r':
-        s += to_str<String_type>("\\r");
-        return true;
-    case '\t':
-        s += to_str<String_type>("\\t");
-        return true;
-    }
-
-    return false;
-}
-
-template<class String_type>
-String_type add_esc_chars(const String_type& s, bool raw_utf8, bool esc_nonascii)
-{
-    typedef typename String_type::const_iterator Iter_type;
-    typedef typename String_type::value_type Char_type;
-
-    String_type result;
-
-    const Iter_type end(s.end());
-
-    for (Iter_type i = s.begin(); i != end; ++i)
-    {
-        const Char_type c(*i);
-
-        if (add_esc_char(c, result))
-            continue;
-
-        if (raw_utf8)
-        {
-            result += c;
-        }
-        else
-        {
-            const wint_t unsigned_c((c >= 0) ? c : 256 + c);
-
-            if (!esc_nonascii && iswprint(unsigned_c))
-            {
-                result += c;
-            }
-            else
-            {
-                result += non_printable_to_string<String_type>(unsigned_c);
-            }
-        }
-    }
-
-    return result;
-}
-
-/**
- * Formats double to string with following garanties:
- *  - scienfic (1e+6) or fixed (1000000.0) format selected depending on value
- *  - numbers in fixed format always have decimal point and at least one digit after it
- *  - there are no trailing zeros after decimal point except one
- * Examples:
- *  0 formatted as 0.0
- *  1.234 formatted as 1.234
- *  1e+80 formatted as 1e+80
- */
-class JsonDoubleFormatter
-{
-public:
-    JsonDoubleFormatter()
-    {
-        // JSON formatting must be locale-independent.
-        stream_.imbue(std::locale::classic());
-        // Only numbers with decimal point parsed as double,
-        //  so we always output numbers with decimal point.
-        stream_.setf(std::ios_base::showpoint);
-        // Precision 17 is enough to represent double values with maximum precision.
-        stream_.precision(17);
-    }
-
-    std::string operator()(double value) const
-    {
-        stream_.str("");
-        stream_ << value;
-        std::string str = stream_.str();
-        normalize_number(str);
-        return str;
-    }
-
-private:
-    void normalize_number(std::string& str) const
-    {
-        size_t dot_pos = str.find('.');
-        if (dot_pos != std::string::npos)
-        {
-            size_t end = str.find('e', dot_pos);
-            if (end == std::string::npos)
-            {
-                end = str.size();
-            }
-
-            if (dot_pos + 1 == end)
-            {
-                // trailing decimal point is not allowed, we should add zero.
-                str.insert(dot_pos + 1, "0");
-            }
-            else
-            {
-                // there are trailing zeros, we prefer to remove them
-                size_t begin = end;
-                while (begin > dot_pos + 2 && (str[begin - 1]) == '0')
-                {
-                    --begin;
-                }
-                if (end > begin)
-                {
-                    str.erase(begin, end - begin);
-                }
-            }
-        }
-    }
-
-    mutable std::stringstream stream_;
-};
-
 // this class generates the JSON text,
 // it keeps track of the indentation level etc.
 //
-template<class Value_type, class Ostream_type>
+// The text is written to a sink, see json_spirit_output_sinks.h.
+//
+template<class Value_type, class Sink_type>
 class Generator
 {
     typedef typename Value_type::Config_type Config_type;
@@ -203,8 +53,8 @@ class Generator
     typedef typename Object_type::value_type Obj_member_type;
 
 public:
-    Generator(const Value_type& value, Ostream_type& os, int options)
-        : os_(os)
+    Generator(const Value_type& value, Sink_type& sink, int options)
+        : sink_(sink)
         , indentation_level_(0)
         , pretty_((options & pretty_print) != 0 || (options & single_line_arrays) != 0)
         , raw_utf8_((options & raw_utf8) != 0)
@@ -223,7 +73,18 @@ private:
             output(value.get_obj());
             break;
         case array_type:
-            output(value.get_array());
+            if (value.is_int64_array())
+            {
+                output_packed(value.get_int64_array());
+            }
+            else if (value.is_real_array())
+            {
+                output_packed(value.get_real_array());
+            }
+            else
+            {
+                output(value.get_array());
+            }
             break;
         case str_type:
             output(value.get_str());
@@ -235,7 +96,7 @@ private:
             output_number(value);
             break;
         case null_type:
-            os_ << "null";
+            output_literal("null");
             break;
         default:
             assert(false);
@@ -251,7 +112,7 @@ private:
     {
         output(Config_type::get_name(member));
         space();
-        os_ << ':';
+        sink_.put(':');
         space();
         output(Config_type::get_value(member));
     }
@@ -260,27 +121,248 @@ private:
     {
         if (value.is_uint64())
         {
-            os_ << value.get_uint64();
+            output_number(value.get_uint64());
         }
         else if (value.is_int64())
         {
-            os_ << value.get_int64();
+            output_number(value.get_int64());
         }
         else
         {
-            // TODO: avoid extra copying for UTF-8 specialization.
-            os_ << to_str<String_type>(double_formatter_(value.get_real()).c_str());
+            output_number(value.get_real());
         }
     }
 
+    void output_number(boost::uint64_t u)
+    {
+        char text[max_integer_length];
+
+        output_ascii(text, format_uint64(u, text) - text);
+    }
+
+    void output_number(boost::int64_t i)
+    {
+        char text[max_integer_length];
+
+        output_ascii(text, format_int64(i, text) - text);
+    }
+
+    void output_number(double d)
+    {
+        char text[max_double_length];
+
+        output_ascii(text, format_double(d, text) - text);
+    }
+
+    // the runs of characters that need no escaping, usually the whole string, are
+    // written to the sink as they are
+    //
+    // Narrow strings are taken to be UTF-8: valid sequences are written as they are, or
+    // as "\uXXXX" escapes of their code points with always_escape_nonascii, and the
+    // bytes of invalid sequences are escaped as if they were Latin-1 characters. Wide
+    // strings are taken to be UTF-16 or UTF-32 depending on the size of wchar_t.
+    //
     void output(const String_type& s)
     {
-        os_ << '"' << add_esc_chars(s, raw_utf8_, esc_nonascii_) << '"';
+        const Char_type* i = s.data();
+        const Char_type* const end = i + s.size();
+
+        sink_.put('"');
+
+        while (i != end)
+        {
+            const Char_type* const run_end = simd::find_escape_candidate(i, end, !raw_utf8_);
+
+            if (run_end != i)
+            {
+                sink_.write(i, run_end - i);
+            }
+
+            if (run_end == end)
+            {
+                break;
+            }
+
+            i = output_escaped(run_end, end);
+        }
+
+        sink_.put('"');
+    }
+
+    // writes the characters starting at 'i' that find_escape_candidate() stopped at,
+    // returns the end of the characters written
+    //
+    const Char_type* output_escaped(const Char_type* i, const Char_type* end)
+    {
+        switch (*i)
+        {
+        case '"':
+            output_literal("\\\"");
+            return i + 1;
+        case '\\':
+            output_literal("\\\\");
+            return i + 1;
+        case '\b':
+            output_literal("\\b");
+            return i + 1;
+        case '\f':
+            output_literal("\\f");
+            return i + 1;
+        case '\n':
+            output_literal("\\n");
+            return i + 1;
+        case '\r':
+            output_literal("\\r");
+            return i + 1;
+        case '\t':
+            output_literal("\\t");
+            return i + 1;
+        }
+
+        if (raw_utf8_)
+        {
+            sink_.put(*i);
+
+            return i + 1;
+        }
+
+        return output_nonprintable(i, end, std::is_same<Char_type, char>());
+    }
+
+    const Char_type* output_nonprintable(const Char_type* i, const Char_type* end, std::true_type /* narrow */)
+    {
+        if (static_cast<unsigned char>(*i) < 0x80)
+        {
+            output_unicode_escape(static_cast<unsigned char>(*i)); // a control character or DEL
+
+            return i + 1;
+        }
+
+        // a run of non-ASCII characters, e.g. a word in another script, is written at once
+
+        const Char_type* run_end = i;
+        boost::uint32_t code_point = 0;
+
+        while (run_end != end && static_cast<unsigned char>(*run_end) >= 0x80)
+        {
+            const std::size_t length = utf8::decode(run_end, end, code_point);
+
+            if (length == 0 || esc_nonascii_)
+            {
+                break;
+            }
+
+            run_end += length;
+        }
+
+        if (run_end != i)
+        {
+            sink_.write(i, run_end - i);
+
+            return run_end;
+        }
+
+        const std::size_t length = utf8::decode(i, end, code_point);
+
+        if (length == 0)
+        {
+            output_unicode_escape(static_cast<unsigned char>(*i));
+
+            return i + 1;
+        }
+
+        output_code_point_escape(code_point);
+
+        return i + length;
+    }
+
+    const Char_type* output_nonprintable(const Char_type* i, const Char_type* /* end */, std::false_type /* narrow */)
+    {
+        const wint_t c(*i);
+
+        if (c >= 0x80 && !esc_nonascii_ && iswprint(c))
+        {
+            sink_.put(*i);
+        }
+        else
+        {
+            output_code_point_escape(static_cast<boost::uint32_t>(c));
+        }
+
+        return i + 1;
+    }
+
+    // code points beyond the Basic Multilingual Plane are escaped as UTF-16 surrogate pairs
+    //
+    void output_code_point_escape(boost::uint32_t code_point)
+    {
+        if (code_point > 0xFFFF)
+        {
+            code_point -= 0x10000;
+
+            output_unicode_escape(0xD800 + (code_point >> 10));
+            output_unicode_escape(0xDC00 + (code_point & 0x3FF));
+        }
+        else
+        {
+            output_unicode_escape(code_point);
+        }
+    }
+
+    void output_unicode_escape(unsigned int c)
+    {
+        char text[6] = { '\\', 'u' };
+
+        text[5] = to_hex_char(c & 0x000F);
+        c >>= 4;
+        text[4] = to_hex_char(c & 0x000F);
+        c >>= 4;
+        text[3] = to_hex_char(c & 0x000F);
+        c >>= 4;
+        text[2] = to_hex_char(c & 0x000F);
+
+        output_ascii(text, sizeof(text));
     }
 
     void output(bool b)
     {
-        os_ << to_str<String_type>(b ? "true" : "false");
+        if (b)
+        {
+            output_literal("true");
+        }
+        else
+        {
+            output_literal("false");
+        }
+    }
+
+    template<std::size_t N>
+    void output_literal(const char (&literal)[N])
+    {
+        output_ascii(literal, N - 1);
+    }
+
+    // numbers and literals are formatted as chars, whatever the type of the text,
+    // and widened in one go for wide text
+    //
+    void output_ascii(const char* s, std::size_t n)
+    {
+        output_ascii(s, n, std::is_same<Char_type, char>());
+    }
+
+    void output_ascii(const char* s, std::size_t n, std::true_type /* narrow */)
+    {
+        sink_.write(reinterpret_cast<const Char_type*>(s), n);
+    }
+
+    void output_ascii(const char* s, std::size_t n, std::false_type /* narrow */)
+    {
+        Char_type text[max_double_length];
+
+        assert(n <= max_double_length);
+
+        std::copy(s, s + n, text);
+        sink_.write(text, n);
     }
 
     static bool contains_composite_elements(const Array_type& arr)
@@ -305,7 +387,7 @@ private:
 
         if (++i != last)
         {
-            os_ << ',';
+            sink_.put(',');
         }
     }
 
@@ -313,7 +395,7 @@ private:
     {
         if (single_line_arrays_ && !contains_composite_elements(arr))
         {
-            os_ << '[';
+            sink_.put('[');
             space();
 
             for (typename Array_type::const_iterator i = arr.begin(); i != arr.end(); ++i)
@@ -323,7 +405,7 @@ private:
                 space();
             }
 
-            os_ << ']';
+            sink_.put(']');
         }
         else
         {
@@ -331,10 +413,61 @@ private:
         }
     }
 
+    // the numbers of a packed array are written without creating its values,
+    // laid out like any other array of numbers
+    //
+    template<class Number>
+    void output_packed(const std::vector<Number>& numbers)
+    {
+        sink_.put('[');
+
+        if (single_line_arrays_)
+        {
+            space();
+        }
+        else
+        {
+            new_line();
+            ++indentation_level_;
+        }
+
+        for (typename std::vector<Number>::const_iterator i = numbers.begin(); i != numbers.end(); ++i)
+        {
+            if (!single_line_arrays_)
+            {
+                indent();
+            }
+
+            output_number(*i);
+
+            if (i + 1 != numbers.end())
+            {
+                sink_.put(',');
+            }
+
+            if (single_line_arrays_)
+            {
+                space();
+            }
+            else
+            {
+                new_line();
+            }
+        }
+
+        if (!single_line_arrays_)
+        {
+            --indentation_level_;
+            indent();
+        }
+
+        sink_.put(']');
+    }
+
     template<class T>
     void output_array_or_obj(const T& t, Char_type start_char, Char_type end_char)
     {
-        os_ << start_char;
+        sink_.put(start_char);
         new_line();
 
         ++indentation_level_;
@@ -351,7 +484,7 @@ private:
         --indentation_level_;
 
         indent();
-        os_ << end_char;
+        sink_.put(end_char);
     }
 
     void indent()
@@ -361,33 +494,44 @@ private:
 
         for (int i = 0; i < indentation_level_; ++i)
         {
-            os_ << "    ";
+            output_literal("    ");
         }
     }
 
     void space()
     {
         if (pretty_)
-            os_ << ' ';
+            sink_.put(' ');
     }
 
     void new_line()
     {
         if (pretty_)
-            os_ << '\n';
+            sink_.put('\n');
     }
 
     Generator& operator=(const Generator&); // to prevent "assignment operator could not be generated" warning
 
-    Ostream_type& os_;
+    Sink_type& sink_;
     int indentation_level_;
     bool pretty_;
     bool raw_utf8_;
     bool esc_nonascii_;
     bool single_line_arrays_;
-    JsonDoubleFormatter double_formatter_;
 };
 
+// writes JSON Value to a sink, e.g.
+//
+// std::vector< char > response;
+// Append_sink< std::vector< char > > sink( response );
+// write_to_sink( value, sink, pretty_print );
+//
+template<class Value_type, class Sink_type>
+void write_to_sink(const Value_type& value, Sink_type& sink, int options = none)
+{
+    Generator<Value_type, Sink_type>(value, sink, options);
+}
+
 // writes JSON Value to a stream, e.g.
 //
 // write_stream( value, os, pretty_print );
@@ -395,8 +539,9 @@ private:
 template<class Value_type, class Ostream_type>
 void write_stream(const Value_type& value, Ostream_type& os, int options = none)
 {
-    os << std::dec;
-    Generator<Value_type, Ostream_type>(value, os, options);
+    Ostream_sink<Ostream_type> sink(os);
+
+    write_to_sink(value, sink, options);
 }
 
 // writes JSON Value to a stream, e.g.
@@ -404,15 +549,16 @@ void write_stream(const Value_type& value, Ostream_type& os, int options = none)
 // const string json_str = write( value, pretty_print );
 //
 template<class Value_type>
-typename Value_type::String_type write_string(const Value_type& value, int options = none)
+std::basic_string<typename Value_type::String_type::value_type> write_string(const Value_type& value, int options = none)
 {
-    typedef typename Value_type::String_type::value_type Char_type;
+    typedef std::basic_string<typename Value_type::String_type::value_type> Text_type;
 
-    std::basic_ostringstream<Char_type> os;
+    Text_type text;
+    Append_sink<Text_type> sink(text);
 
-    write_stream(value, os, options);
+    write_to_sink(value, sink, options);
 
-    return os.str();
+    return text;
 }
 }
 
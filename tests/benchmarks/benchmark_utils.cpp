@@ -0,0 +1,12 @@
+//          Copyright John W. Wilkinson 2007 - 2014
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+
+#include "benchmark_utils.h"
+#include <cstdio>
+
+void report_benchmark(const std::string& name, std::size_t calls, std::chrono::nanoseconds elapsed)
+{
+    const double ns_per_call = static_cast<double>(elapsed.count()) / static_cast<double>(calls);
+
+    std::printf("%-48s %12.0f ns/call %10zu calls\n", name.c_str(), ns_per_call, calls);
+}
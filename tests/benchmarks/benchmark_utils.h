@@ -0,0 +1,44 @@
+//          Copyright John W. Wilkinson 2007 - 2014
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+
+#pragma once
+#include <chrono>
+#include <string>
+
+// Each group of benchmarks prints one line per benchmark with the mean
+// latency of a call, run with no arguments to get all of them or with
+// the names of the groups to run.
+
+void run_reader_benchmarks();
+void run_large_array_benchmarks();
+void run_writer_benchmarks();
+
+void report_benchmark(const std::string& name, std::size_t calls, std::chrono::nanoseconds elapsed);
+
+// calls fn until a second has passed, fn is called once before
+// timing starts so that caches and allocations are warm
+//
+template<class Function>
+void run_benchmark(const std::string& name, Function fn)
+{
+    typedef std::chrono::steady_clock Clock;
+
+    fn();
+
+    const Clock::time_point start = Clock::now();
+    const Clock::duration min_time = std::chrono::seconds(1);
+
+    std::size_t calls = 0;
+    Clock::duration elapsed;
+    do
+    {
+        for (int i = 0; i < 16; ++i)
+        {
+            fn();
+        }
+        calls += 16;
+        elapsed = Clock::now() - start;
+    } while (elapsed < min_time);
+
+    report_benchmark(name, calls, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed));
+}
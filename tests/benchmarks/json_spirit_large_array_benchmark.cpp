@@ -0,0 +1,74 @@
+//          Copyright John W. Wilkinson 2007 - 2014
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+
+#include "benchmark_utils.h"
+#include "json_spirit_reader_template.h"
+#include "json_spirit_value.h"
+#include <sstream>
+
+using namespace json_spirit;
+
+namespace
+{
+const int element_count = 1000000;
+
+std::string make_number_array()
+{
+    std::ostringstream os;
+    os << '[';
+    for (int i = 0; i < element_count; ++i)
+    {
+        os << (i != 0 ? "," : "") << i * 7;
+    }
+    os << ']';
+    return os.str();
+}
+
+// one pair per object, so the objects grow as often as the array does
+//
+std::string make_object_array()
+{
+    std::ostringstream os;
+    os << '[';
+    for (int i = 0; i < element_count; ++i)
+    {
+        os << (i != 0 ? "," : "") << "{\"id\":" << i << '}';
+    }
+    os << ']';
+    return os.str();
+}
+
+template<class Value_type>
+void run_large_array_reader_benchmarks(const std::string& type_name, const std::string& text, const std::string& what)
+{
+    const std::string suffix = "<" + type_name + "> " + what;
+
+    Reader<Value_type> reader;
+    run_benchmark("Reader::read(string)" + suffix, [&]() {
+        Value_type value;
+        reader.read(text, value);
+    });
+
+    Reader<Value_type> presizing_reader(presize_containers);
+    run_benchmark("Reader(presize_containers)::read(string)" + suffix, [&]() {
+        Value_type value;
+        presizing_reader.read(text, value);
+    });
+
+    Reader<Value_type> packing_reader(pack_numeric_arrays);
+    run_benchmark("Reader(pack_numeric_arrays)::read(string)" + suffix, [&]() {
+        Value_type value;
+        packing_reader.read(text, value);
+    });
+}
+}
+
+void run_large_array_benchmarks()
+{
+    const std::string numbers = make_number_array();
+    const std::string objects = make_object_array();
+
+    run_large_array_reader_benchmarks<Value>("Value", numbers, "10^6 numbers");
+    run_large_array_reader_benchmarks<Value>("Value", objects, "10^6 objects");
+    run_large_array_reader_benchmarks<mValue>("mValue", numbers, "10^6 numbers");
+}
@@ -0,0 +1,127 @@
+//          Copyright John W. Wilkinson 2007 - 2014
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+
+#include "benchmark_utils.h"
+#include "json_spirit_reader.h"
+#include "json_spirit_reader_template.h"
+#include "json_spirit_sax_reader.h"
+#include "json_spirit_value.h"
+#include <sstream>
+#include <vector>
+
+using namespace json_spirit;
+
+namespace
+{
+// a message like the ones sent by a telemetry agent, roughly entries * 100 bytes
+//
+std::string make_message(int entries)
+{
+    std::ostringstream os;
+    os << "{\"host\":\"node-17.example.com\",\"sequence\":918273,\"samples\":[";
+    for (int i = 0; i < entries; ++i)
+    {
+        if (i != 0)
+        {
+            os << ',';
+        }
+        os << "{\"id\":" << 1000 + i
+           << ",\"name\":\"sensor " << i << "\""
+           << ",\"value\":" << i * 0.25 - 3.5
+           << ",\"ok\":" << (i % 3 != 0 ? "true" : "false")
+           << ",\"tags\":[\"a\",\"b\"]}";
+    }
+    os << "],\"error\":null}";
+    return os.str();
+}
+
+template<class Value_type>
+void run_small_document_benchmarks(const std::string& type_name)
+{
+    for (int entries : { 1, 10, 40 })
+    {
+        const std::string message = make_message(entries);
+        const std::string suffix = "<" + type_name + "> " + std::to_string(message.size()) + " bytes";
+
+        run_benchmark("read(string)" + suffix, [&]() {
+            Value_type value;
+            read_string(message, value);
+        });
+
+        Reader<Value_type> reader;
+        run_benchmark("Reader::read(string)" + suffix, [&]() {
+            Value_type value;
+            reader.read(message, value);
+        });
+
+        run_benchmark("read_sax(string)" + suffix, [&]() {
+            Null_sax_handler<typename Value_type::String_type> handler;
+            read_sax(message, handler);
+        });
+
+        run_benchmark("read(istream)" + suffix, [&]() {
+            std::istringstream is(message);
+            Value_type value;
+            read_stream(is, value);
+        });
+
+        run_benchmark("Reader::read(istream)" + suffix, [&]() {
+            std::istringstream is(message);
+            Value_type value;
+            reader.read(is, value);
+        });
+    }
+}
+
+void run_in_situ_benchmarks()
+{
+    for (int entries : { 1, 10, 40 })
+    {
+        const std::string message = make_message(entries);
+        const std::string suffix = "<vValue> " + std::to_string(message.size()) + " bytes";
+
+        // the copy stands for receiving the message into a buffer
+        std::vector<char> buffer;
+        run_benchmark("read_in_situ(char*)" + suffix, [&]() {
+            buffer.assign(message.begin(), message.end());
+            vValue value;
+            read_in_situ(buffer.data(), buffer.size(), value);
+        });
+    }
+}
+
+#ifdef JSON_SPIRIT_STD_PMR
+void run_memory_resource_benchmarks()
+{
+    for (int entries : { 1, 10, 40, 1000 })
+    {
+        const std::string message = make_message(entries);
+        const std::string suffix = "<Value_pmr> " + std::to_string(message.size()) + " bytes";
+
+        // the whole document, including its destruction, in one arena
+        run_benchmark("read(string, arena)" + suffix, [&]() {
+            std::pmr::monotonic_buffer_resource arena;
+            Value_pmr value;
+            read_string(message, value, &arena);
+        });
+    }
+
+    const std::string message = make_message(1000);
+    run_benchmark("read(string)<Value> " + std::to_string(message.size()) + " bytes", [&]() {
+        Value value;
+        read_string(message, value);
+    });
+}
+#endif
+}
+
+void run_reader_benchmarks()
+{
+    run_small_document_benchmarks<Value>("Value");
+    run_small_document_benchmarks<mValue>("mValue");
+    run_small_document_benchmarks<cValue>("cValue");
+    run_in_situ_benchmarks();
+#ifdef JSON_SPIRIT_STD_PMR
+    run_memory_resource_benchmarks();
+#endif
+}
@@ -0,0 +1,167 @@
+//          Copyright John W. Wilkinson 2007 - 2014
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+
+#include "benchmark_utils.h"
+#include "json_spirit_reader_template.h"
+#include "json_spirit_value.h"
+#include "json_spirit_writer_template.h"
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace json_spirit;
+
+namespace
+{
+// a response like the ones of a telemetry service, roughly entries * 100 bytes
+//
+Value make_response(int entries)
+{
+    Array samples;
+    for (int i = 0; i < entries; ++i)
+    {
+        Object sample;
+        Config::add(sample, "id", 1000 + i);
+        Config::add(sample, "name", "sensor " + std::to_string(i));
+        Config::add(sample, "value", i * 0.25 - 3.5);
+        Config::add(sample, "ok", i % 3 != 0);
+        Config::add(sample, "tags", Array{ "a", "b" });
+        samples.push_back(std::move(sample));
+    }
+
+    Object response;
+    Config::add(response, "host", "node-17.example.com");
+    Config::add(response, "sequence", 918273);
+    Config::add(response, "samples", std::move(samples));
+    Config::add(response, "error", Value());
+    return response;
+}
+
+// identifiers as a database would hand them out, all of them 13 digits
+//
+std::vector<boost::int64_t> make_ids(int count)
+{
+    std::vector<boost::int64_t> ids;
+    for (int i = 0; i < count; ++i)
+    {
+        ids.push_back(1000000000000LL + i * 7919LL);
+    }
+    return ids;
+}
+
+// messages such as log lines, long and rarely needing an escape
+//
+void run_string_benchmarks()
+{
+    const std::string line = "2014-06-01T12:00:00Z worker-3 finished job 4711 for tenant acme in 35 ms, "
+                             "queue depth 12, next poll in 250 ms";
+
+    Array lines(1000, line);
+    lines.back() = line + "\n\tcaused by \"timeout\"";
+    const Value messages(std::move(lines));
+
+    // the same in German and Japanese, mostly ASCII and mostly not
+    //
+    const Value utf8_messages(Array(1000, "2014-06-01T12:00:00Z worker-3 hat Auftrag 4711 f\xC3\xBCr M\xC3\xBCller in 35 ms erledigt, "
+                                          "\xE3\x82\xB8\xE3\x83\xA7\xE3\x83\x96\xE3\x81\x8C\xE5\xAE\x8C\xE4\xBA\x86\xE3\x81\x97\xE3\x81\xBE\xE3\x81\x97\xE3\x81\x9F"));
+
+    std::string text;
+    for (int options : { 0, int(raw_utf8) })
+    {
+        run_benchmark(std::string("write_to_sink(Append_sink<string>) 1000 log lines") + (options != 0 ? " raw_utf8" : ""), [&]() {
+            text.clear();
+            Append_sink<std::string> sink(text);
+            write_to_sink(messages, sink, options);
+        });
+    }
+
+    for (int options : { 0, int(always_escape_nonascii) })
+    {
+        run_benchmark(std::string("write_to_sink(Append_sink<string>) 1000 UTF-8 log lines") + (options != 0 ? " always_escape_nonascii" : ""), [&]() {
+            text.clear();
+            Append_sink<std::string> sink(text);
+            write_to_sink(utf8_messages, sink, options);
+        });
+    }
+}
+
+void run_id_benchmarks()
+{
+    const int count = 100000;
+    const std::vector<boost::int64_t> ids = make_ids(count);
+
+    const Value id_array(Array(ids.begin(), ids.end()));
+    const Value packed_ids(ids);
+    const wValue wide_id_array(wArray(ids.begin(), ids.end()));
+
+    Array records;
+    for (int i = 0; i < count; ++i)
+    {
+        Object record;
+        Config::add(record, "id", ids[i]);
+        Config::add(record, "parent_id", ids[i / 2]);
+        records.push_back(std::move(record));
+    }
+    const Value record_array(std::move(records));
+
+    std::string text;
+    run_benchmark("write_to_sink(Append_sink<string>) " + std::to_string(count) + " ids", [&]() {
+        text.clear();
+        Append_sink<std::string> sink(text);
+        write_to_sink(id_array, sink);
+    });
+
+    run_benchmark("write_to_sink(Append_sink<string>) " + std::to_string(count) + " packed ids", [&]() {
+        text.clear();
+        Append_sink<std::string> sink(text);
+        write_to_sink(packed_ids, sink);
+    });
+
+    run_benchmark("write_to_sink(Append_sink<string>) " + std::to_string(count) + " {id,parent_id}", [&]() {
+        text.clear();
+        Append_sink<std::string> sink(text);
+        write_to_sink(record_array, sink);
+    });
+
+    std::wstring wide_text;
+    run_benchmark("write_to_sink(Append_sink<wstring>) " + std::to_string(count) + " ids", [&]() {
+        wide_text.clear();
+        Append_sink<std::wstring> sink(wide_text);
+        write_to_sink(wide_id_array, sink);
+    });
+}
+}
+
+void run_writer_benchmarks()
+{
+    for (int entries : { 1, 10, 40 })
+    {
+        const Value response = make_response(entries);
+        const std::string suffix = " " + std::to_string(write_string(response).size()) + " bytes";
+
+        run_benchmark("write_string" + suffix, [&]() {
+            write_string(response);
+        });
+
+        run_benchmark("write_stream(ostringstream)" + suffix, [&]() {
+            std::ostringstream os;
+            write_stream(response, os);
+        });
+
+        std::vector<char> buffer;
+        run_benchmark("write_to_sink(Append_sink<vector<char>>) reused" + suffix, [&]() {
+            buffer.clear();
+            Append_sink<std::vector<char>> sink(buffer);
+            write_to_sink(response, sink);
+        });
+
+        char fixed[8192];
+        run_benchmark("write_to_sink(Buffer_sink)" + suffix, [&]() {
+            Buffer_sink<char> sink(fixed, sizeof(fixed));
+            write_to_sink(response, sink);
+        });
+    }
+
+    run_id_benchmarks();
+    run_string_benchmarks();
+}
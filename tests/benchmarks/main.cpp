@@ -0,0 +1,51 @@
+//          Copyright John W. Wilkinson 2007 - 2014
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+
+#include "benchmark_utils.h"
+#include <cstring>
+#include <iostream>
+
+namespace
+{
+struct Benchmark_group
+{
+    const char* name;
+    void (*run)();
+};
+
+const Benchmark_group groups[] = {
+    { "reader", &run_reader_benchmarks },
+    { "large_arrays", &run_large_array_benchmarks },
+    { "writer", &run_writer_benchmarks },
+};
+
+bool is_selected(const char* name, int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        return true;
+    }
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], name) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+}
+
+int main(int argc, char** argv)
+{
+    for (const Benchmark_group& group : groups)
+    {
+        if (is_selected(group.name, argc, argv))
+        {
+            std::cout << "== " << group.name << std::endl;
+            group.run();
+        }
+    }
+    return 0;
+}
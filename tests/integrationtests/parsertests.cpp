@@ -5,6 +5,7 @@
 #include <boost/test/data/monomorphic.hpp>
 #include <fstream>
 #include <iomanip>
+#include <sstream>
 
 #include "json_spirit_reader.h"
 #include "json_spirit_value.h"
@@ -49,6 +50,8 @@ struct test_cases
     std::vector<path> broken_files;
     // parse may either fail or be successful, there are no strict requirement in JSON RFC documents
     std::vector<path> undefined_files;
+    // all files above
+    std::vector<path> all_files;
 };
 
 test_cases get_all_json_in_dir(const path& dir)
@@ -62,6 +65,7 @@ test_cases get_all_json_in_dir(const path& dir)
         if (is_regular_file(item) && item.extension() == jsonExt)
         {
             const std::string filename = item.filename().string();
+            cases.all_files.push_back(item);
             if (boost::starts_with(filename, "y_"))
             {
                 cases.correct_files.push_back(item);
@@ -137,6 +141,23 @@ BOOST_DATA_TEST_CASE(does_not_throw_on_undefined_files, data::make(get_test_case
     BOOST_CHECK_NO_THROW(json_spirit::read(content, value));
 }
 
+BOOST_DATA_TEST_CASE(string_and_stream_parsers_agree, data::make(get_test_cases().all_files), filepath)
+{
+    const std::string content = read_whole_file(filepath);
+    std::istringstream stream(content);
+
+    json_spirit::Value string_value;
+    json_spirit::Value stream_value;
+    const bool string_succeed = json_spirit::read(content, string_value);
+    const bool stream_succeed = json_spirit::read(stream, stream_value);
+
+    BOOST_CHECK_EQUAL(string_succeed, stream_succeed);
+    if (string_succeed && stream_succeed)
+    {
+        BOOST_CHECK_EQUAL(string_value, stream_value);
+    }
+}
+
 // FIXME: after first and second rewrite JSON must be the same, but it isn't
 #if 0
 BOOST_DATA_TEST_CASE(correct_files_a_same_after_two_writes, data::make(get_test_cases().correct_files), filepath)
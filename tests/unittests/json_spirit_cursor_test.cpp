@@ -0,0 +1,175 @@
+//          Copyright John W. Wilkinson 2007 - 2014
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+
+// json spirit version 4.08
+
+#include "stdafx.h"
+#include "json_spirit_cursor.h"
+#include "json_spirit_reader.h"
+#include "test_utils.h"
+
+using namespace json_spirit;
+using namespace std;
+using namespace boost;
+
+namespace
+{
+// one word per token, e.g. "{ name:a num:1 }"
+template<class String>
+std::string readAllTokens(const String& source)
+{
+    Json_cursor<String> cursor(source);
+
+    std::string tokens;
+    for (Token_type token = cursor.next(); token != end_token; token = cursor.next())
+    {
+        if (!tokens.empty())
+        {
+            tokens += ' ';
+        }
+
+        switch (token)
+        {
+        case begin_obj_token:
+            tokens += '{';
+            break;
+        case end_obj_token:
+            tokens += '}';
+            break;
+        case begin_array_token:
+            tokens += '[';
+            break;
+        case end_array_token:
+            tokens += ']';
+            break;
+        case name_token:
+            tokens += "name:" + encoding_cast<std::string>(cursor.get_str());
+            break;
+        case str_token:
+            tokens += "str:" + encoding_cast<std::string>(cursor.get_str());
+            break;
+        case number_token:
+            tokens += "num:" + std::string(cursor.token_begin(), cursor.token_end());
+            break;
+        case bool_token:
+            tokens += cursor.get_bool() ? "true" : "false";
+            break;
+        case null_token:
+            tokens += "null";
+            break;
+        case no_token:
+        case end_token:
+            BOOST_FAIL("unexpected token");
+            break;
+        }
+    }
+    BOOST_CHECK_EQUAL(cursor.depth(), 0u);
+    return tokens;
+}
+}
+
+std::string CURSOR_TEST_DATA[] = {
+    "{}",
+    "[1,2,]",
+    "{\"a\":1,}",
+    "{\"a\" 1}",
+    "{\"a\":}",
+    "[1 2]",
+    "[\"unterminated]",
+    "[true, false, null, \"s\", -1.5e3]",
+    "{\"a\":{\"b\":[[],{}]},\"c\":\"d\"}",
+    "/* comment */ [1, // comment\n 2]",
+    "[1] ",
+    "[1] x",
+    "[1] // comment",
+    "",
+    "  ",
+};
+
+BOOST_AUTO_TEST_SUITE()
+
+BOOST_AUTO_TEST_CASE(cursor_reads_tokens)
+{
+    BOOST_CHECK_EQUAL(readAllTokens(std::string("{\"a\":[1,-2.5,{}],\"b\\n\":{\"c\":\"d\"},\"e\":true,\"f\":null}")),
+        "{ name:a [ num:1 num:-2.5 { } ] name:b\n { name:c str:d } name:e true name:f null }");
+    BOOST_CHECK_EQUAL(readAllTokens(utf8_to_wstring("[\"x\", false]")), "[ str:x false ]");
+    BOOST_CHECK_EQUAL(readAllTokens(std::string(" 42 ")), "num:42");
+}
+
+BOOST_DATA_TEST_CASE(cursor_accepts_what_read_accepts, CURSOR_TEST_DATA, source)
+{
+    Value value;
+    const bool readSucceeded = json_spirit::read(source, value);
+
+    bool cursorSucceeded = true;
+    try
+    {
+        readAllTokens(source);
+    }
+    catch (const std::runtime_error&)
+    {
+        cursorSucceeded = false;
+    }
+    BOOST_CHECK_EQUAL(cursorSucceeded, readSucceeded);
+}
+
+BOOST_AUTO_TEST_CASE(cursor_can_stop_early_and_skip)
+{
+    // everything after "route" is never looked at
+    const std::string source = "{\"big\":{\"x\":[1,[2,3],{\"y\":\"]\"}]},\"list\":[4,5],\"route\":\"north\", this is not JSON";
+
+    Json_cursor<std::string> cursor(source);
+    BOOST_REQUIRE_EQUAL(cursor.next(), begin_obj_token);
+
+    std::string route;
+    while (cursor.next() == name_token)
+    {
+        if (cursor.get_str() == "route")
+        {
+            BOOST_REQUIRE_EQUAL(cursor.next(), str_token);
+            route = cursor.get_str();
+            break;
+        }
+        cursor.skip();
+        BOOST_CHECK_EQUAL(cursor.depth(), 1u);
+    }
+    BOOST_CHECK_EQUAL(route, "north");
+}
+
+BOOST_AUTO_TEST_CASE(cursor_can_read_values)
+{
+    const std::string source = "[{\"a\":[1,{\"b\":null}]}, 18446744073709551615, \"s\", {\"c\":{\"d\":2}}]";
+
+    Json_cursor<std::string> cursor(source);
+    BOOST_REQUIRE_EQUAL(cursor.next(), begin_array_token);
+    BOOST_REQUIRE_EQUAL(cursor.next(), begin_obj_token);
+
+    Value first;
+    cursor.get_value(first);
+    BOOST_CHECK_EQUAL(cursor.token(), end_obj_token);
+    BOOST_CHECK_EQUAL(cursor.depth(), 1u);
+    Value expectedFirst;
+    json_spirit::read("{\"a\":[1,{\"b\":null}]}", expectedFirst);
+    BOOST_CHECK_EQUAL(first, expectedFirst);
+
+    BOOST_REQUIRE_EQUAL(cursor.next(), number_token);
+    BOOST_CHECK_EQUAL(cursor.get_number().kind, uint64_number);
+    Value number;
+    cursor.get_value(number);
+    BOOST_CHECK_EQUAL(number.get_uint64(), 18446744073709551615u);
+
+    BOOST_REQUIRE_EQUAL(cursor.next(), str_token);
+    BOOST_REQUIRE_EQUAL(cursor.next(), begin_obj_token);
+    BOOST_REQUIRE_EQUAL(cursor.next(), name_token);
+
+    mValue inner;
+    cursor.get_value(inner);
+    BOOST_CHECK_EQUAL(inner.get_obj().at("d").get_int64(), 2);
+
+    BOOST_CHECK_EQUAL(cursor.next(), end_obj_token);
+    BOOST_CHECK_EQUAL(cursor.next(), end_array_token);
+    BOOST_CHECK_EQUAL(cursor.next(), end_token);
+    BOOST_CHECK_EQUAL(cursor.next(), end_token);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
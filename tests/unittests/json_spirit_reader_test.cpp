@@ -5,7 +5,15 @@
 #include "test_utils.h"
 
 #include "json_spirit_reader.h"
+#include "json_spirit_reader_template.h"
+#include "json_spirit_simd.h"
+#include "json_spirit_utils.h"
 #include "json_spirit_value.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <sstream>
 #include "json_spirit_writer.h"
 
 using namespace json_spirit;
@@ -102,6 +110,169 @@ std::string SYNTAX_FAIL_TEST_DATA[] = {
     // "[1, 2, 3],",
 };
 
+// Inputs where Json_fast_parser must agree with Json_grammar, including the
+// non-standard extensions accepted by the grammar.
+std::string FAST_PARSER_TEST_DATA[] = {
+    "true",
+    "false",
+    "null",
+    "\"text\"",
+    "42",
+    "-42",
+    "1.5",
+    ".5",
+    "+1.5",
+    "1e5",
+    "1E+5",
+    "-2.5e-3",
+    "01",
+    "1.",
+    "1e",
+    "-",
+    "18446744073709551615",
+    "18446744073709551616",
+    "-9223372036854775808",
+    "-9223372036854775809",
+    "[truex]",
+    "[nul]",
+    "[1,2,]",
+    "{\"a\":1,}",
+    "{\"a\" 1}",
+    "{\"a\":}",
+    "{1:2}",
+    "[\"\\x41\\x7F\"]",
+    "[\"\\xFF\"]",
+    "[\"\\x\"]",
+    "[\"\\101\\0\"]",
+    "[\"\\q\\'\"]",
+    "[\"\\u0041\\u00e9\"]",
+    "[\"a\\\"b\"]",
+    "[\"unterminated]",
+    "[\"new\nline\"]",
+    "[\"tail\n\"]",
+    "// comment\n[1]",
+    "/* comment */ [1, /* inner */ 2]",
+    "[1 // comment\r\n, 2]",
+    "[1 /* unterminated",
+    "[1] // trailing comment",
+    "[1] \t\r\n\v\f",
+    "[1] x",
+    "{\"a\":{\"b\":[{},[],\"c\"]}}",
+    "",
+    " ",
+};
+
+template<class Value>
+void checkFastParserAgreesWithGrammar(const typename Value::String_type& source)
+{
+    Value fastValue;
+    Value grammarValue;
+
+    auto stream = make_string_stream(source);
+    const bool fastSucceed = json_spirit::read(source, fastValue);
+    const bool grammarSucceed = json_spirit::read(stream, grammarValue);
+
+    BOOST_CHECK_EQUAL(fastSucceed, grammarSucceed);
+    if (fastSucceed && grammarSucceed)
+    {
+        BOOST_CHECK_EQUAL(fastValue, grammarValue);
+    }
+}
+
+// Character by character equivalent of simd::Structural_index::build().
+std::vector<uint32_t> build_reference_index(const std::string& text)
+{
+    std::vector<uint32_t> positions;
+    bool in_string = false;
+    bool boundary = true;
+    for (size_t i = 0; i < text.size(); ++i)
+    {
+        const char c = text[i];
+        if (in_string)
+        {
+            if (c == '\\')
+            {
+                ++i;
+            }
+            else if (c == '"')
+            {
+                positions.push_back(uint32_t(i));
+                in_string = false;
+                boundary = true;
+            }
+            continue;
+        }
+        const bool is_op = std::strchr("{}[]:,", c) != nullptr && c != 0;
+        if (c == '"')
+        {
+            positions.push_back(uint32_t(i));
+            in_string = true;
+        }
+        else if (is_op || (boundary && !is_space_char(c)))
+        {
+            positions.push_back(uint32_t(i));
+        }
+        boundary = is_op || is_space_char(c);
+    }
+    return positions;
+}
+
+// Builds a large document with strings full of escapes and backslash runs
+// crossing 64 character block boundaries.
+std::string make_large_document(unsigned seed, const std::string& separator)
+{
+    std::mt19937 random(seed);
+    const std::string pieces[] = { "a", "\\\\", "\\\"", "\\n", "\\u0041", " ", "\\/", "{", "]", ",", ":", "\xC3\xA9" };
+
+    std::string text = "[";
+    for (int i = 0; text.size() < 2 * structural_index_min_size; ++i)
+    {
+        if (i != 0)
+        {
+            text += "," + separator;
+        }
+        switch (random() % 6)
+        {
+        case 0:
+        {
+            text += "\"";
+            const size_t length = random() % 100;
+            for (size_t j = 0; j < length; ++j)
+            {
+                text += pieces[random() % (sizeof(pieces) / sizeof(pieces[0]))];
+            }
+            text += "\"";
+            break;
+        }
+        case 1:
+            text += "{" + separator + "\"key\\\\\"" + separator + ":" + separator + std::to_string(random()) + "," + separator + "\"k\":[true,false,null]}";
+            break;
+        case 2:
+            text += "-" + std::to_string(random()) + ".25e-3";
+            break;
+        case 3:
+            text += "18446744073709551615";
+            break;
+        case 4:
+            text += "[" + separator + "]";
+            break;
+        default:
+            text += "\"" + std::string(random() % 200, 'x') + "\"";
+            break;
+        }
+    }
+    text += separator + "]";
+    return text;
+}
+
+void checkIndexedReadAgreesWithGrammar(const std::string& source, bool expectIndexed)
+{
+    simd::Structural_index index;
+    BOOST_CHECK_EQUAL(index.build(source.data(), source.data() + source.size()), expectIndexed);
+
+    checkFastParserAgreesWithGrammar<json_spirit::Value>(source);
+}
+
 template<typename Value>
 class ReadTestDataBuilder
 {
@@ -454,6 +625,603 @@ BOOST_DATA_TEST_CASE(parse_fails_on_invalid_json, SYNTAX_FAIL_TEST_DATA, sourceU
     testWideMapValue(sourceUtf16);
 }
 
+BOOST_DATA_TEST_CASE(fast_parser_agrees_with_grammar, FAST_PARSER_TEST_DATA, sourceUtf8)
+{
+    checkFastParserAgreesWithGrammar<json_spirit::Value>(sourceUtf8);
+    checkFastParserAgreesWithGrammar<json_spirit::mValue>(sourceUtf8);
+    checkFastParserAgreesWithGrammar<json_spirit::wValue>(utf8_to_wstring(sourceUtf8));
+    checkFastParserAgreesWithGrammar<json_spirit::wmValue>(utf8_to_wstring(sourceUtf8));
+}
+
+BOOST_AUTO_TEST_CASE(structural_index_matches_reference)
+{
+    const std::string samples[] = {
+        "",
+        "{\"a\":[1, 2.5e3,true ,null] , \"b\\\"\":{}}",
+        "  \"\\\\\" x\"\\\\\\\"\"12 ",
+        make_large_document(1, ""),
+        make_large_document(2, "\n    "),
+    };
+
+    for (const std::string& sample : samples)
+    {
+        simd::Structural_index index;
+        BOOST_REQUIRE(index.build(sample.data(), sample.data() + sample.size()));
+
+        const std::vector<uint32_t> expected = build_reference_index(sample);
+        BOOST_REQUIRE_EQUAL(index.positions().size(), expected.size());
+        BOOST_CHECK(index.positions() == expected);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(indexed_read_agrees_with_grammar)
+{
+    const std::string compact = make_large_document(3, "");
+    const std::string pretty = make_large_document(4, "\n\t  ");
+
+    checkIndexedReadAgreesWithGrammar(compact, true);
+    checkIndexedReadAgreesWithGrammar(pretty, true);
+
+    // errors found while walking the index
+    checkIndexedReadAgreesWithGrammar(compact.substr(0, compact.size() - 1), true);
+    checkIndexedReadAgreesWithGrammar(compact + " x", true);
+    checkIndexedReadAgreesWithGrammar("[truex, " + compact.substr(1), true);
+    checkIndexedReadAgreesWithGrammar("[1 2, " + compact.substr(1), true);
+    checkIndexedReadAgreesWithGrammar(compact.substr(0, compact.size() - 1) + ",]", true);
+
+    // texts which can't be indexed are read character by character
+    checkIndexedReadAgreesWithGrammar("/* comment */" + compact, false);
+    checkIndexedReadAgreesWithGrammar("[\"\\x41\", " + compact.substr(1), false);
+    checkIndexedReadAgreesWithGrammar(compact + "\"", false);
+}
+
+BOOST_AUTO_TEST_CASE(can_read_long_strings_with_escapes)
+{
+    for (size_t length = 0; length < 80; ++length)
+    {
+        const std::string clean(length, 'a');
+        const std::string source = "[\"" + clean + "\\n" + clean + "\\\\\\\"" + clean + "\\u0041" + clean + "\"]";
+        const std::string expected = clean + "\n" + clean + "\\\"" + clean + "A" + clean;
+
+        Value value;
+        BOOST_REQUIRE(json_spirit::read(source, value));
+        BOOST_CHECK_EQUAL(value.get_array().at(0).get_str(), expected);
+
+        wValue wvalue;
+        BOOST_REQUIRE(json_spirit::read(utf8_to_wstring(source), wvalue));
+        BOOST_CHECK(wvalue.get_array().at(0).get_str() == utf8_to_wstring(expected));
+
+        Value broken;
+        BOOST_CHECK(!json_spirit::read("[\"" + clean + "\n" + clean + "x\"]", broken));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(numbers_are_classified_and_converted_exactly)
+{
+    const std::pair<std::string, Value> cases[] = {
+        { "0", Value(0) },
+        { "-0", Value(0) },
+        { "007", Value(7) },
+        { "9223372036854775807", Value(INT64_MAX) },
+        { "-9223372036854775808", Value(INT64_MIN) },
+        { "9223372036854775808", Value(UINT64_C(9223372036854775808)) },
+        { "18446744073709551615", Value(UINT64_MAX) },
+        { "0.1", Value(0.1) },
+        { "-2.5e-3", Value(-2.5e-3) },
+        { "1E+5", Value(1e5) },
+        { ".5", Value(0.5) },
+        { "+1.5", Value(1.5) },
+        { "9007199254740993.0", Value(9007199254740992.0) },
+        { "2.2250738585072011e-308", Value(2.2250738585072011e-308) },
+        { "4.9406564584124654e-324", Value(4.9406564584124654e-324) },
+        { "1.7976931348623157e308", Value(1.7976931348623157e308) },
+        { "1e-400", Value(0.0) },
+        { "1.00000000000000011102230246251565404236316680908203125", Value(1.0) },
+        { "1.00000000000000011102230246251565404236316680908203126", Value(1.0000000000000002) },
+        { "123456789012345678901234567890e-29", Value(1.2345678901234568) },
+    };
+
+    for (const auto& c : cases)
+    {
+        Value value;
+        BOOST_REQUIRE_MESSAGE(json_spirit::read("[" + c.first + "]", value), c.first);
+        const Value& number = value.get_array().at(0);
+        BOOST_CHECK_MESSAGE(number.type() == c.second.type() && number == c.second, c.first);
+
+        std::istringstream is("[" + c.first + "]");
+        Value streamValue;
+        BOOST_REQUIRE(json_spirit::read(is, streamValue));
+        BOOST_CHECK(streamValue == value);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(reals_round_trip_exactly)
+{
+    std::mt19937_64 random(4);
+    for (int i = 0; i < 10000; ++i)
+    {
+        const boost::uint64_t bits = random();
+        double d = 0;
+        std::memcpy(&d, &bits, sizeof(d));
+        if (!std::isfinite(d))
+        {
+            continue;
+        }
+
+        char text[64];
+        std::snprintf(text, sizeof(text), "%.17e", d);
+
+        Value value;
+        BOOST_REQUIRE(json_spirit::read(text, value));
+        const double read = value.get_real();
+        BOOST_CHECK_MESSAGE(std::memcmp(&read, &d, sizeof(d)) == 0, text);
+    }
+}
+
+template<class Value_type>
+void checkReaderAgreesWithReadFunctions()
+{
+    typedef typename Value_type::String_type String_type;
+
+    const std::string sources[] = {
+        "{\"name\":\"first\",\"items\":[1,2.5,{\"deep\":[true,false,null]}]}",
+        "[1, 2,]",
+        "{\"name\":\"second\",\"items\":[]}",
+        "\"just a string\"",
+        "{\"unterminated\":[1,2",
+        "[-1, 18446744073709551615, 1e-3]",
+    };
+
+    json_spirit::Reader<Value_type> reader;
+    for (const auto& sourceUtf8 : sources)
+    {
+        const String_type source = encoding_cast<String_type>(sourceUtf8);
+
+        Value_type expected;
+        const bool expectedOk = json_spirit::read_string(source, expected);
+
+        Value_type value;
+        BOOST_CHECK_EQUAL(reader.read(source, value), expectedOk);
+        if (expectedOk)
+        {
+            BOOST_CHECK_EQUAL(value, expected);
+        }
+
+        auto is = make_string_stream(source);
+        Value_type streamValue;
+        BOOST_CHECK_EQUAL(reader.read(is, streamValue), expectedOk);
+        if (expectedOk)
+        {
+            BOOST_CHECK_EQUAL(streamValue, expected);
+        }
+    }
+
+    Value_type value;
+    const String_type twoValues = encoding_cast<String_type>("[1] {\"a\":2}");
+    typename String_type::const_iterator begin = twoValues.begin();
+    BOOST_CHECK_THROW(reader.read_or_throw(begin, twoValues.end(), value), std::runtime_error);
+    BOOST_CHECK_THROW(reader.read_or_throw(encoding_cast<String_type>("{\"a\" 1}"), value), JsonParseError);
+}
+
+BOOST_AUTO_TEST_CASE(reader_can_be_reused)
+{
+    checkReaderAgreesWithReadFunctions<json_spirit::Value>();
+    checkReaderAgreesWithReadFunctions<json_spirit::mValue>();
+    checkReaderAgreesWithReadFunctions<json_spirit::wValue>();
+    checkReaderAgreesWithReadFunctions<json_spirit::wmValue>();
+}
+
+BOOST_AUTO_TEST_CASE(presized_containers_have_their_final_capacity)
+{
+    std::string source = "{\"empty\": [], \"nested\": [[], [1], {\"a\": \"[,]\"}], \"big\": [";
+    for (int i = 0; i != 1000; ++i)
+    {
+        source += (i == 0 ? "" : ", ") + std::to_string(i);
+    }
+    source += "], \"last\": {}} ";
+
+    Value expected;
+    BOOST_REQUIRE(json_spirit::read(source, expected));
+
+    Reader<Value> reader(presize_containers);
+    Value value;
+    BOOST_REQUIRE(reader.read(source, value));
+    BOOST_CHECK_EQUAL(value, expected);
+
+    const Object& obj = value.get_obj();
+    BOOST_CHECK_EQUAL(obj.capacity(), 4u);
+    BOOST_CHECK_EQUAL(find_value(obj, "big").get_array().capacity(), 1000u);
+    BOOST_CHECK_EQUAL(find_value(obj, "nested").get_array().capacity(), 3u);
+    BOOST_CHECK_EQUAL(find_value(obj, "nested").get_array()[1].get_array().capacity(), 1u);
+
+    // the sizes of one text are not used for the next, nor for invalid text
+    BOOST_REQUIRE(reader.read("[1, 2]", value));
+    BOOST_CHECK_EQUAL(value.get_array().capacity(), 2u);
+    BOOST_CHECK(!reader.read("[1, [2, 3}", value));
+
+    mValue mvalue;
+    Reader<mValue> mreader(presize_containers);
+    BOOST_REQUIRE(mreader.read(source, mvalue));
+    BOOST_CHECK_EQUAL(mvalue.get_obj().at("big").get_array().capacity(), 1000u);
+}
+
+BOOST_AUTO_TEST_CASE(can_read_character_buffers)
+{
+    // not null terminated, only the first 13 characters are JSON
+    const char buffer[] = { '{', '"', 'a', '"', ':', '[', '1', ',', '2', ']', '}', ' ', ' ', 'x', 'x' };
+    const std::size_t length = 13;
+
+    Value expected;
+    BOOST_REQUIRE(json_spirit::read(std::string("{\"a\":[1,2]}"), expected));
+
+    Value fromBuffer;
+    BOOST_REQUIRE(json_spirit::read(buffer, length, fromBuffer));
+    BOOST_CHECK_EQUAL(fromBuffer, expected);
+    BOOST_CHECK(!json_spirit::read(buffer, sizeof(buffer), fromBuffer));
+
+    mValue fromStringRef;
+    BOOST_REQUIRE_NO_THROW(json_spirit::read_or_throw(boost::string_ref(buffer, length), fromStringRef));
+    BOOST_CHECK_EQUAL(fromStringRef.get_obj().at("a").get_array().size(), 2u);
+
+    Value fromLiteral;
+    BOOST_REQUIRE(json_spirit::read("{\"a\":[1,2]}", fromLiteral));
+    BOOST_CHECK_EQUAL(fromLiteral, expected);
+
+    const std::wstring wide = L"[\"w\", 3]";
+    wValue fromWide;
+    BOOST_REQUIRE(json_spirit::read(wide.data(), wide.size(), fromWide));
+    BOOST_CHECK(fromWide.get_array().at(0).get_str() == L"w");
+
+    wmValue fromWideRef;
+    BOOST_REQUIRE(json_spirit::read(boost::wstring_ref(wide), fromWideRef));
+    BOOST_CHECK_EQUAL(fromWideRef.get_array().at(1).get_int64(), 3);
+
+    try
+    {
+        Value value;
+        json_spirit::read_or_throw(buffer, sizeof(buffer), value);
+        BOOST_FAIL("no exception thrown");
+    }
+    catch (const JsonParseError& e)
+    {
+        BOOST_CHECK_EQUAL(e.get_line(), 1u);
+        BOOST_CHECK_EQUAL(e.get_column(), 14u);
+        BOOST_CHECK_EQUAL(e.get_reason(), "unexpected trailing characters");
+    }
+}
+
+// copies a value with another Config, e.g. a vValue to a Value
+//
+template<class View_value_type, class Value_type>
+Value_type copyValue(const View_value_type& view)
+{
+    using String_type = typename Value_type::String_type;
+
+    switch (view.type())
+    {
+    case obj_type:
+    {
+        typename Value_type::Object obj;
+        for (const auto& pair : view.get_obj())
+        {
+            obj.push_back(typename Value_type::Config_type::Pair_type(String_type(pair.name_.begin(), pair.name_.end()),
+                copyValue<View_value_type, Value_type>(pair.value_)));
+        }
+        return obj;
+    }
+    case array_type:
+    {
+        typename Value_type::Array array;
+        for (const auto& element : view.get_array())
+        {
+            array.push_back(copyValue<View_value_type, Value_type>(element));
+        }
+        return array;
+    }
+    case str_type:
+        return String_type(view.get_str().begin(), view.get_str().end());
+    case bool_type:
+        return view.get_bool();
+    case number_type:
+        if (view.is_int64())
+        {
+            return view.get_int64();
+        }
+        if (view.is_uint64())
+        {
+            return view.get_uint64();
+        }
+        return view.get_real();
+    case null_type:
+        break;
+    }
+    return Value_type();
+}
+
+void checkInSituAgreesWithRead(const std::string& text)
+{
+    Value expected;
+    BOOST_REQUIRE(json_spirit::read(text, expected));
+
+    std::vector<char> buffer(text.begin(), text.end());
+    vValue value;
+    BOOST_REQUIRE(json_spirit::read_in_situ(buffer.data(), buffer.size(), value));
+    BOOST_CHECK_EQUAL((copyValue<vValue, Value>(value)), expected);
+
+    const std::wstring wideText(text.begin(), text.end());
+    wValue wideExpected;
+    BOOST_REQUIRE(json_spirit::read(wideText, wideExpected));
+
+    std::vector<wchar_t> wideBuffer(wideText.begin(), wideText.end());
+    wvValue wideValue;
+    BOOST_REQUIRE_NO_THROW(json_spirit::read_in_situ_or_throw(wideBuffer.data(), wideBuffer.size(), wideValue));
+    BOOST_CHECK((copyValue<wvValue, wValue>(wideValue) == wideExpected));
+}
+
+BOOST_AUTO_TEST_CASE(can_read_in_situ)
+{
+    checkInSituAgreesWithRead("[]");
+    checkInSituAgreesWithRead("\"\"");
+    checkInSituAgreesWithRead("\"\\n\"");
+    checkInSituAgreesWithRead("{\"name\": \"value\", \"n\": -1.5e3, \"t\": true, \"f\": false, \"z\": null}");
+    checkInSituAgreesWithRead("{\"k\\tey\": [\"a\\\"b\\\\c\\u0041\\x42\\n\", \"plain\", {\"\\/\": \"\\r\\n\"}]}");
+    checkInSituAgreesWithRead("[\"\\\\\\\\\", \"x\\\\\", \"\\\\y\", \"\\u00e9\\u00e9\\u00e9\", 18446744073709551615]");
+
+    // strings without escape sequences point into the buffer
+    char buffer[] = "{\"key\":[\"value\",\"es\\tcaped\"]}";
+    vValue value;
+    BOOST_REQUIRE(json_spirit::read_in_situ(buffer, sizeof(buffer) - 1, value));
+    const vPair& pair = value.get_obj().at(0);
+    BOOST_CHECK(pair.name_ == "key");
+    BOOST_CHECK_EQUAL(pair.name_.data(), buffer + 2);
+    const vArray& array = pair.value_.get_array();
+    BOOST_CHECK(array.at(0).get_str() == "value");
+    BOOST_CHECK_EQUAL(array.at(0).get_str().data(), buffer + 9);
+    BOOST_CHECK(array.at(1).get_str() == "es\tcaped");
+    BOOST_CHECK_EQUAL(array.at(1).get_str().data(), buffer + 17);
+}
+
+BOOST_AUTO_TEST_CASE(failed_read_in_situ_restores_buffer)
+{
+    const std::string text = "[\"a\\nb\", {\"c\\td\": \"\\u0041\"},\n \"e\\\\f\", ]";
+
+    Value expectedValue;
+    const JsonParseError expected = [&] {
+        try
+        {
+            json_spirit::read_or_throw(text, expectedValue);
+        }
+        catch (const JsonParseError& e)
+        {
+            return e;
+        }
+        return JsonParseError(0, 0, "no exception thrown");
+    }();
+
+    std::vector<char> buffer(text.begin(), text.end());
+    vValue value;
+    BOOST_CHECK(!json_spirit::read_in_situ(buffer.data(), buffer.size(), value));
+    BOOST_CHECK(std::string(buffer.begin(), buffer.end()) == text);
+
+    try
+    {
+        json_spirit::read_in_situ_or_throw(buffer.data(), buffer.size(), value);
+        BOOST_FAIL("no exception thrown");
+    }
+    catch (const JsonParseError& e)
+    {
+        BOOST_CHECK(e == expected);
+        BOOST_CHECK_EQUAL(e.get_line(), 2u);
+    }
+    BOOST_CHECK(std::string(buffer.begin(), buffer.end()) == text);
+}
+
+#ifdef JSON_SPIRIT_STD_PMR
+// counts the allocations passed on to another resource
+//
+class Counting_resource : public std::pmr::memory_resource
+{
+public:
+    explicit Counting_resource(std::pmr::memory_resource* upstream)
+        : upstream_(upstream)
+    {
+    }
+
+    int allocations_ = 0;
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        ++allocations_;
+        return upstream_->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
+    {
+        upstream_->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+
+    std::pmr::memory_resource* upstream_;
+};
+
+BOOST_AUTO_TEST_CASE(can_read_into_memory_resource)
+{
+    const std::string text = "{\"name\": \"a string too long for the small string buffer\", "
+                             "\"list\": [1, 2.5, \"three\", {\"es\\tcaped key\": null}, [true, false]]}";
+
+    Value expected;
+    BOOST_REQUIRE(json_spirit::read(text, expected));
+
+    Counting_resource defaultResource(std::pmr::new_delete_resource());
+    std::pmr::memory_resource* const oldDefault = std::pmr::set_default_resource(&defaultResource);
+
+    Counting_resource arena(std::pmr::new_delete_resource());
+    {
+        Value_pmr value;
+        BOOST_CHECK(json_spirit::read_string(text, value, &arena));
+        BOOST_CHECK_EQUAL((copyValue<Value_pmr, Value>(value)), expected);
+
+        mValue_pmr mValue;
+        std::istringstream is(text);
+        BOOST_CHECK_NO_THROW(json_spirit::read_stream_or_throw(is, mValue, &arena));
+        BOOST_CHECK(mValue.get_obj().at("list").get_array().at(3).get_obj().count("es\tcaped key") == 1);
+    }
+    std::pmr::set_default_resource(oldDefault);
+
+    BOOST_CHECK_GT(arena.allocations_, 0);
+    BOOST_CHECK_EQUAL(defaultResource.allocations_, 0);
+}
+#endif
+
+BOOST_AUTO_TEST_CASE(can_read_hash_objects)
+{
+    const std::string source = "{\"b\": 1, \"a\": [true, {\"c\": null}], \"b\": \"last\"}";
+
+    hValue value;
+    BOOST_REQUIRE(json_spirit::read(source, value));
+
+    const hObject& obj = value.get_obj();
+    BOOST_CHECK_EQUAL(obj.size(), 2u);
+    BOOST_CHECK_EQUAL(obj.begin()->name_, "b");
+    BOOST_CHECK_EQUAL(obj.at("b").get_str(), "last");
+    BOOST_CHECK(obj.at("a").get_array()[1].get_obj().at("c").is_null());
+    BOOST_CHECK_EQUAL(json_spirit::write(value), "{\"b\":\"last\",\"a\":[true,{\"c\":null}]}");
+
+    std::istringstream is(source);
+    hValue fromStream;
+    BOOST_REQUIRE(json_spirit::read(is, fromStream));
+    BOOST_CHECK_EQUAL(fromStream, value);
+
+    whValue wvalue;
+    BOOST_REQUIRE(json_spirit::read(L"{\"x\": 1}", wvalue));
+    BOOST_CHECK_EQUAL(wvalue.get_obj().at(L"x").get_int64(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(can_read_interned_strings)
+{
+    const std::string source = "[{\"status\": \"ok\", \"id\": 1}, {\"status\": \"ok\", \"id\": 2}, \"st\\u0061tus\"]";
+
+    iValue value;
+    BOOST_REQUIRE(json_spirit::read_string(source, value));
+
+    const iArray& arr = value.get_array();
+    const iPair& first = arr[0].get_obj()[0];
+    const iPair& second = arr[1].get_obj()[0];
+    BOOST_CHECK_EQUAL(first.name_, "status");
+    BOOST_CHECK_EQUAL(first.name_.data(), second.name_.data());
+    BOOST_CHECK_EQUAL(first.value_.get_str().data(), second.value_.get_str().data());
+    BOOST_CHECK_EQUAL(arr[2].get_str().data(), first.name_.data()); // unescaped before interning
+    BOOST_CHECK_EQUAL(find_value(arr[1].get_obj(), "id").get_int64(), 2);
+    BOOST_CHECK_EQUAL(json_spirit::write_string(value), "[{\"status\":\"ok\",\"id\":1},{\"status\":\"ok\",\"id\":2},\"status\"]");
+
+    imValue mvalue;
+    BOOST_REQUIRE(json_spirit::read_string(source, mvalue));
+    BOOST_CHECK_EQUAL(mvalue.get_array()[1].get_obj().find("status")->first.data(), first.name_.data());
+}
+
+BOOST_AUTO_TEST_CASE(can_read_small_objects_and_arrays)
+{
+    const std::string source = "{\"id\":7,\"point\":[1.5,2.5],\"tags\":[\"a\",\"b\",\"c\",\"d\",\"e\",\"f\"],\"empty\":{}}";
+
+    cValue value;
+    BOOST_REQUIRE(json_spirit::read_string(source, value));
+    BOOST_CHECK_EQUAL(json_spirit::write_string(value), source);
+    BOOST_CHECK_EQUAL(find_value(value.get_obj(), "tags").get_array().size(), 6u);
+
+    Reader<cValue> reader(presize_containers);
+    cValue presized;
+    BOOST_REQUIRE(reader.read(source, presized));
+    BOOST_CHECK(presized == value);
+}
+
+BOOST_AUTO_TEST_CASE(can_read_copy_on_write_values)
+{
+    const std::string source = "{\"servers\": [{\"host\": \"a\"}, {\"host\": \"b\"}], \"port\": 80}";
+
+    sValue value;
+    BOOST_REQUIRE(json_spirit::read_string(source, value));
+
+    const sValue cached = value;
+    value.get_obj()[1].value_ = 8080;
+    BOOST_CHECK_EQUAL(json_spirit::write_string(cached), "{\"servers\":[{\"host\":\"a\"},{\"host\":\"b\"}],\"port\":80}");
+    BOOST_CHECK_EQUAL(json_spirit::write_string(value), "{\"servers\":[{\"host\":\"a\"},{\"host\":\"b\"}],\"port\":8080}");
+
+    smValue mvalue;
+    BOOST_REQUIRE(json_spirit::read_string(source, mvalue));
+    BOOST_CHECK_EQUAL(json_spirit::write_string(mvalue), "{\"port\":80,\"servers\":[{\"host\":\"a\"},{\"host\":\"b\"}]}");
+}
+
+BOOST_AUTO_TEST_CASE(can_read_packed_numeric_arrays)
+{
+    const std::string source = "[[1, 2, -3], [1.5, 2.5], [1, 2.5], [], {\"a\": [4]}, [18446744073709551615], [\"1\"]]";
+
+    Value expected;
+    BOOST_REQUIRE(json_spirit::read_string(source, expected));
+
+    Reader<Value> reader(pack_numeric_arrays);
+    Value value;
+    BOOST_REQUIRE(reader.read(source, value));
+
+    const Array& arr = value.get_array();
+    BOOST_CHECK(arr[0].is_int64_array());
+    BOOST_CHECK(arr[0].get_int64_array() == std::vector<boost::int64_t>({ 1, 2, -3 }));
+    BOOST_CHECK(arr[1].is_real_array());
+    BOOST_CHECK(arr[1].get_real_array() == std::vector<double>({ 1.5, 2.5 }));
+    BOOST_CHECK(arr[4].get_obj()[0].value_.is_int64_array());
+    for (int i : { 2, 3, 5, 6 }) // mixed, empty, uint64 and not numbers
+    {
+        BOOST_CHECK(!arr[i].is_int64_array() && !arr[i].is_real_array());
+    }
+
+    BOOST_CHECK_EQUAL(value, expected);
+    BOOST_CHECK_EQUAL(write_string(value), write_string(expected));
+    BOOST_CHECK_EQUAL(write_string(value, pretty_print), write_string(expected, pretty_print));
+    BOOST_CHECK_EQUAL(write_string(value, single_line_arrays), write_string(expected, single_line_arrays));
+
+    std::istringstream is(source);
+    BOOST_REQUIRE(reader.read(is, value));
+    BOOST_CHECK(value.get_array()[1].is_real_array());
+}
+
+BOOST_AUTO_TEST_CASE(can_read_contiguous_ranges)
+{
+    const std::string source = "[1, \"two\", {\"three\": 3.0}] [4]";
+    Value expected;
+    BOOST_REQUIRE(json_spirit::read("[1, \"two\", {\"three\": 3.0}]", expected));
+
+    const char* begin = source.data();
+    Value fromPointers;
+    BOOST_REQUIRE(json_spirit::read_range(begin, source.data() + source.size(), fromPointers, true));
+    BOOST_CHECK_EQUAL(fromPointers, expected);
+    BOOST_CHECK_EQUAL(begin - source.data(), 26);
+
+    const std::vector<char> buffer(source.begin(), source.end());
+    Value fromVector;
+    BOOST_CHECK(json_spirit::read_range_or_throw(buffer.begin(), buffer.end(), fromVector, true) == buffer.begin() + 26);
+    BOOST_CHECK_EQUAL(fromVector, expected);
+    BOOST_CHECK_THROW(json_spirit::read_range_or_throw(buffer.begin(), buffer.end(), fromVector, false), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(read_or_throw_reports_error_position)
+{
+    Value value;
+    try
+    {
+        json_spirit::read_or_throw(std::string("{\n  \"a\": 1,\n  \"b\" 2\n}"), value);
+        BOOST_ERROR("exception expected");
+    }
+    catch (const JsonParseError& e)
+    {
+        BOOST_CHECK_EQUAL(e.get_reason(), "no colon in pair");
+        BOOST_CHECK_EQUAL(e.get_line(), 3u);
+    }
+}
+
 BOOST_DATA_TEST_CASE(read_values_equal_to_expected_for_string, ReadTestHelper<std::string>::get_test_data(), data)
 {
     ReadTestHelper<std::string>::checkRead(data);
@@ -0,0 +1,202 @@
+//          Copyright John W. Wilkinson 2007 - 2014
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+
+// json spirit version 4.08
+
+#include "stdafx.h"
+#include "json_spirit_reader.h"
+#include "json_spirit_sax_reader.h"
+#include "test_utils.h"
+
+using namespace json_spirit;
+using namespace std;
+using namespace boost;
+
+namespace
+{
+// writes one line per event
+template<class String>
+class RecordingHandler
+{
+public:
+    void begin_obj() { m_log += "{\n"; }
+    void end_obj() { m_log += "}\n"; }
+    void begin_array() { m_log += "[\n"; }
+    void end_array() { m_log += "]\n"; }
+    void key(const String& name) { m_log += "key " + encoding_cast<std::string>(name) + "\n"; }
+    void string_value(const String& s) { m_log += "str " + encoding_cast<std::string>(s) + "\n"; }
+    void int64_value(boost::int64_t i) { m_log += "int " + std::to_string(i) + "\n"; }
+    void uint64_value(boost::uint64_t ui) { m_log += "uint " + std::to_string(ui) + "\n"; }
+    void real_value(double d) { m_log += "real " + std::to_string(d) + "\n"; }
+    void bool_value(bool b) { m_log += b ? "true\n" : "false\n"; }
+    void null_value() { m_log += "null\n"; }
+
+    const std::string& log() const { return m_log; }
+
+private:
+    std::string m_log;
+};
+
+// the events a Value would have produced when it was read
+template<class Value>
+void recordValue(const Value& value, RecordingHandler<typename Value::String_type>& handler)
+{
+    switch (value.type())
+    {
+    case obj_type:
+        handler.begin_obj();
+        for (const auto& pair : value.get_obj())
+        {
+            handler.key(Value::Config_type::get_name(pair));
+            recordValue(Value::Config_type::get_value(pair), handler);
+        }
+        handler.end_obj();
+        break;
+    case array_type:
+        handler.begin_array();
+        for (const auto& element : value.get_array())
+        {
+            recordValue(element, handler);
+        }
+        handler.end_array();
+        break;
+    case str_type:
+        handler.string_value(value.get_str());
+        break;
+    case bool_type:
+        handler.bool_value(value.get_bool());
+        break;
+    case number_type:
+        if (value.is_uint64())
+        {
+            handler.uint64_value(value.get_uint64());
+        }
+        else if (value.is_int64())
+        {
+            handler.int64_value(value.get_int64());
+        }
+        else
+        {
+            handler.real_value(value.get_real());
+        }
+        break;
+    case null_type:
+        handler.null_value();
+        break;
+    }
+}
+
+template<class Value>
+void checkSaxEventsMatchValue(const typename Value::String_type& source)
+{
+    typedef typename Value::String_type String;
+
+    Value value;
+    BOOST_REQUIRE(json_spirit::read_string(source, value));
+
+    RecordingHandler<String> expected;
+    recordValue(value, expected);
+
+    RecordingHandler<String> fromString;
+    BOOST_REQUIRE(json_spirit::read_sax(source, fromString));
+    BOOST_CHECK_EQUAL(fromString.log(), expected.log());
+
+    auto stream = make_string_stream(source);
+    RecordingHandler<String> fromStream;
+    BOOST_REQUIRE_NO_THROW(json_spirit::read_sax_or_throw(stream, fromStream));
+    BOOST_CHECK_EQUAL(fromStream.log(), expected.log());
+}
+
+struct NumberSummer : Null_sax_handler<std::string>
+{
+    void int64_value(boost::int64_t i) { sum += static_cast<double>(i); }
+    void real_value(double d) { sum += d; }
+
+    double sum = 0;
+};
+
+struct HandlerError : std::runtime_error
+{
+    HandlerError()
+        : std::runtime_error("handler error")
+    {
+    }
+};
+
+// stops the reading at the key "b"
+struct StoppingHandler : Null_sax_handler<std::string>
+{
+    void key(const std::string& name)
+    {
+        ++keys;
+
+        if (name == "b")
+        {
+            throw HandlerError();
+        }
+    }
+
+    int keys = 0;
+};
+}
+
+std::string SAX_TEST_DATA[] = {
+    "{}",
+    "[]",
+    "\"text\"",
+    "-12",
+    "[1, -2, 18446744073709551615, 0.5, true, false, null, \"a\\nb\"]",
+    "{\"name\":\"value\",\"nested\":{\"array\":[{},[],{\"x\":[1]}]},\"last\":null}",
+    "/* comment */ {\"a\" : [ 1 , 2 ] // tail\n}",
+};
+
+BOOST_AUTO_TEST_SUITE()
+
+BOOST_DATA_TEST_CASE(sax_events_match_value, SAX_TEST_DATA, sourceUtf8)
+{
+    checkSaxEventsMatchValue<json_spirit::Value>(sourceUtf8);
+    checkSaxEventsMatchValue<json_spirit::wValue>(utf8_to_wstring(sourceUtf8));
+}
+
+BOOST_AUTO_TEST_CASE(sax_handler_can_ignore_events)
+{
+    NumberSummer summer;
+    BOOST_REQUIRE(json_spirit::read_sax(std::string("{\"a\":[1,2.5,\"3\"],\"b\":{\"c\":-4}}"), summer));
+    BOOST_CHECK_EQUAL(summer.sum, -0.5);
+}
+
+BOOST_AUTO_TEST_CASE(sax_reports_errors)
+{
+    const std::string source = "{\"a\":[1,2],\n\"b\" 3}";
+
+    RecordingHandler<std::string> handler;
+    BOOST_CHECK(!json_spirit::read_sax(source, handler));
+    BOOST_CHECK_EQUAL(handler.log(), "{\nkey a\n[\nint 1\nint 2\n]\nkey b\n");
+
+    RecordingHandler<std::string> throwingHandler;
+    try
+    {
+        json_spirit::read_sax_or_throw(source, throwingHandler);
+        BOOST_FAIL("no exception thrown");
+    }
+    catch (const JsonParseError& e)
+    {
+        BOOST_CHECK_EQUAL(e.get_line(), 2u);
+        BOOST_CHECK_EQUAL(e.get_reason(), "no colon in pair");
+    }
+    BOOST_CHECK_EQUAL(throwingHandler.log(), handler.log());
+
+    std::istringstream stream(source);
+    RecordingHandler<std::string> streamHandler;
+    BOOST_CHECK(!json_spirit::read_sax(stream, streamHandler));
+    BOOST_CHECK_EQUAL(streamHandler.log(), handler.log());
+}
+
+BOOST_AUTO_TEST_CASE(sax_handler_errors_are_not_lost)
+{
+    StoppingHandler handler;
+    BOOST_CHECK_THROW(json_spirit::read_sax_or_throw(std::string("{\"a\":1,\"b\":2,\"c\":3}"), handler), HandlerError);
+    BOOST_CHECK_EQUAL(handler.keys, 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -4,9 +4,15 @@
 // json spirit version 4.08
 
 #include "stdafx.h"
+#include "json_spirit_utils.h"
 #include "test_utils.h"
+#include <algorithm>
+#include <atomic>
 #include <climits>
 #include <cstdint>
+#include <thread>
+#include <type_traits>
+#include <utility>
 
 using namespace json_spirit;
 using namespace std;
@@ -275,6 +281,149 @@ BOOST_DATA_TEST_CASE(can_copy_value, COPY_TEST_DATA, value)
     BOOST_CHECK_EQUAL(value, anotherCopy);
 }
 
+BOOST_DATA_TEST_CASE(can_move_value, COPY_TEST_DATA, value)
+{
+    static_assert(std::is_nothrow_move_constructible<Value>::value, "Value must be nothrow movable");
+    static_assert(std::is_nothrow_move_assignable<mValue>::value, "mValue must be nothrow movable");
+
+    Value copy = value;
+    Value moved = std::move(copy);
+    Value anotherMoved;
+    anotherMoved = std::move(moved);
+
+    BOOST_CHECK_EQUAL(value, anotherMoved);
+    BOOST_CHECK_EQUAL(value.type(), anotherMoved.type());
+
+    anotherMoved = std::move(anotherMoved);
+    BOOST_CHECK_EQUAL(value, anotherMoved);
+}
+
+BOOST_AUTO_TEST_CASE(moving_does_not_copy_subtrees)
+{
+    Array inner{ 1, "two", 3.0 };
+    const Value* const innerData = inner.data();
+
+    Array outer;
+    outer.push_back(std::move(inner));
+    BOOST_CHECK_EQUAL(outer.front().get_array().data(), innerData);
+
+    // growing the outer array moves the inner one
+    for (int i = 0; i < 100; ++i)
+    {
+        outer.push_back(i);
+    }
+    BOOST_CHECK_EQUAL(outer.front().get_array().data(), innerData);
+
+    Object obj;
+    std::string name = "key";
+    Value& added = Config::add(obj, std::move(name), std::move(outer));
+    BOOST_CHECK_EQUAL(added.get_array().front().get_array().data(), innerData);
+
+    mObject mObj;
+    mArray mInner{ 1, 2 };
+    const mValue* const mInnerData = mInner.data();
+    mConfig::add(mObj, "key", mValue(std::move(mInner)));
+    BOOST_CHECK_EQUAL(mObj.at("key").get_array().data(), mInnerData);
+}
+
+BOOST_AUTO_TEST_CASE(values_are_compact)
+{
+    BOOST_CHECK_LE(sizeof(Value), 16u);
+    BOOST_CHECK_LE(sizeof(wmValue), 16u);
+
+    Value value = Array{ 1, 2 };
+    Value moved = std::move(value);
+    BOOST_CHECK(value.is_null());
+    BOOST_CHECK_EQUAL(moved.get_array().size(), 2u);
+}
+
+BOOST_AUTO_TEST_CASE(copy_on_write_values_share_subtrees_until_changed)
+{
+    sObject inner;
+    sConfig::add(inner, "list", sArray{ 1, 2, 3 });
+    sObject doc;
+    sConfig::add(doc, "inner", inner);
+    sConfig::add(doc, "name", "doc");
+
+    const sValue original = doc;
+    sValue copy = original;
+    BOOST_CHECK_EQUAL(&static_cast<const sValue&>(copy).get_obj(), &original.get_obj());
+    BOOST_CHECK(copy == original);
+
+    // changing a nested array only copies the containers above it, the rest stays shared
+    const sArray& sharedList = original.get_obj()[0].value_.get_obj()[0].value_.get_array();
+    copy.get_obj()[0].value_.get_obj()[0].value_.get_array().push_back(4);
+    BOOST_CHECK_NE(&static_cast<const sValue&>(copy).get_obj(), &original.get_obj());
+    BOOST_CHECK_EQUAL(sharedList.size(), 3u);
+    BOOST_CHECK_EQUAL(copy.get_obj()[0].value_.get_obj()[0].value_.get_array().size(), 4u);
+    BOOST_CHECK_EQUAL(original.get_obj()[1].value_.get_str(), "doc");
+    BOOST_CHECK(!(copy == original));
+
+    // an unshared value is changed in place
+    sArray& list = copy.get_obj()[0].value_.get_obj()[0].value_.get_array();
+    BOOST_CHECK_EQUAL(&copy.get_obj()[0].value_.get_obj()[0].value_.get_array(), &list);
+
+    const smValue mOriginal = smObject{ { "a", smArray{ 1 } } };
+    smValue mCopy = mOriginal;
+    mCopy.get_obj()["b"] = 2;
+    const smValue& mChanged = mCopy;
+    BOOST_CHECK_EQUAL(mOriginal.get_obj().size(), 1u);
+    BOOST_CHECK_EQUAL(mChanged.get_obj().size(), 2u);
+    BOOST_CHECK_EQUAL(&mChanged.get_obj().at("a").get_array(), &mOriginal.get_obj().at("a").get_array());
+}
+
+BOOST_AUTO_TEST_CASE(packed_arrays_can_be_used_as_arrays)
+{
+    const Value packed = std::vector<double>{ 0.5, 1.5 };
+    BOOST_CHECK_EQUAL(packed.type(), array_type);
+    BOOST_CHECK(packed.is_real_array());
+    BOOST_CHECK_EQUAL(packed.get_real_array().size(), 2u);
+    BOOST_CHECK_THROW(packed.get_int64_array(), std::runtime_error);
+
+    // the array of values is created once
+    const Array& arr = packed.get_array();
+    BOOST_CHECK_EQUAL(&packed.get_array(), &arr);
+    BOOST_CHECK_EQUAL(arr[1].get_real(), 1.5);
+    BOOST_CHECK_EQUAL(packed, (Array{ 0.5, 1.5 }));
+    BOOST_CHECK(!(packed == Value(std::vector<boost::int64_t>{ 0, 1 })));
+
+    Value copy = packed;
+    BOOST_CHECK(copy.is_real_array());
+    copy.get_array().push_back("three");
+    BOOST_CHECK(!copy.is_real_array());
+    BOOST_CHECK_EQUAL(copy.get_array().size(), 3u);
+    BOOST_CHECK_EQUAL(packed.get_real_array().size(), 2u);
+
+    const sValue shared = std::vector<boost::int64_t>{ 7, 8 };
+    const sValue sharedCopy = shared;
+    BOOST_CHECK_EQUAL(&sharedCopy.get_int64_array(), &shared.get_int64_array());
+}
+
+BOOST_AUTO_TEST_CASE(small_objects_and_arrays_hold_their_elements_in_place)
+{
+    cObject obj;
+    cConfig::add(obj, "x", 1);
+    cConfig::add(obj, "y", cArray{ 2.5, 3.5 });
+    const cValue value = obj;
+
+    const cArray& arr = value.get_obj()[1].value_.get_array();
+    const char* const begin = reinterpret_cast<const char*>(&arr);
+    const char* const data = reinterpret_cast<const char*>(arr.data());
+    BOOST_CHECK(data >= begin && data < begin + sizeof(cArray));
+    BOOST_CHECK_EQUAL(arr[1].get_real(), 3.5);
+    BOOST_CHECK_EQUAL(find_value(value.get_obj(), "x").get_int64(), 1);
+
+    // larger ones grow like vectors
+    cArray large;
+    for (int i = 0; i < 100; ++i)
+    {
+        large.push_back(i);
+    }
+    const cValue copy = cValue(large);
+    BOOST_CHECK_EQUAL(copy.get_array().size(), 100u);
+    BOOST_CHECK(copy == cValue(large));
+}
+
 BOOST_AUTO_TEST_CASE(can_use_map_for_objets)
 {
     mObject object;
@@ -288,6 +437,235 @@ BOOST_AUTO_TEST_CASE(can_use_map_for_objets)
     BOOST_CHECK_EQUAL(object.find("key 2")->second.get_str(), "another value");
 }
 
+BOOST_AUTO_TEST_CASE(can_use_hash_for_objects)
+{
+    hObject object;
+    object["key 1"] = 1;
+    object["key 2"] = "another value";
+    object["key 1"] = "hello";
+
+    BOOST_CHECK_EQUAL(object.size(), size_t(2));
+    BOOST_CHECK_EQUAL(object.begin()->name_, "key 1");
+    BOOST_CHECK_EQUAL(object.at("key 1").get_str(), "hello");
+    BOOST_CHECK_EQUAL(object.find("key 2")->value_.get_str(), "another value");
+    BOOST_CHECK(object.find("key 3") == object.end());
+    BOOST_CHECK_EQUAL(object.count("key 3"), size_t(0));
+    BOOST_CHECK_THROW(object.at("key 3"), std::out_of_range);
+    BOOST_CHECK_EQUAL(find_value(object, "key 2").get_str(), "another value");
+    BOOST_CHECK(find_value(object, "key 3").is_null());
+
+    BOOST_CHECK(!object.insert(hPair("key 2", 2)).second);
+    BOOST_CHECK(!hConfig::add(object, "key 2", 2).is_null());
+    BOOST_CHECK_EQUAL(object.at("key 2").get_int64(), 2);
+    BOOST_CHECK_EQUAL(object.size(), size_t(2));
+}
+
+BOOST_AUTO_TEST_CASE(hash_objects_keep_order_when_indexed)
+{
+    hObject object;
+
+    for (int i = 0; i != 1000; ++i)
+    {
+        object.insert(hPair("key " + to_string(i), i));
+    }
+
+    BOOST_CHECK_EQUAL(object.erase("key 0"), size_t(1));
+    BOOST_CHECK_EQUAL(object.erase("key 0"), size_t(0));
+    object.erase(object.begin() + 499); // key 500
+
+    BOOST_CHECK_EQUAL(object.size(), size_t(998));
+    BOOST_CHECK_EQUAL(object.begin()->name_, "key 1");
+    BOOST_CHECK_EQUAL((object.end() - 1)->name_, "key 999");
+
+    for (int i = 1; i != 1000; ++i)
+    {
+        BOOST_CHECK_EQUAL(object.count("key " + to_string(i)), size_t(i == 500 ? 0 : 1));
+    }
+
+    BOOST_CHECK_EQUAL(object.at("key 501").get_int64(), 501);
+    BOOST_CHECK_EQUAL((object.begin() + 499)->name_, "key 501");
+
+    hObject copy = object;
+    BOOST_CHECK(copy == object);
+    BOOST_CHECK_EQUAL(copy.at("key 999").get_int64(), 999);
+}
+
+BOOST_AUTO_TEST_CASE(can_find_pairs_of_large_vector_objects)
+{
+    Object object;
+
+    for (int i = 0; i != 100; ++i)
+    {
+        object.push_back(Pair("key " + to_string(i), i));
+    }
+
+    const Object& constObject = object;
+    BOOST_CHECK_EQUAL(constObject.find("key 42")->value_.get_int64(), 42);
+    BOOST_CHECK(constObject.find("key 100") == constObject.end());
+    BOOST_CHECK_EQUAL(find_value(constObject, "key 99").get_int64(), 99);
+
+    object.emplace_back("key 100", 100); // added to the index
+    BOOST_CHECK_EQUAL(find_value(constObject, "key 100").get_int64(), 100);
+
+    object[0].name_ = "renamed"; // drops the index
+    BOOST_CHECK_EQUAL(constObject.count("key 0"), size_t(0));
+    BOOST_CHECK_EQUAL(constObject.count("renamed"), size_t(1));
+
+    object.erase(object.begin() + 1);
+    BOOST_CHECK_EQUAL(constObject.count("key 1"), size_t(0));
+    BOOST_CHECK_EQUAL(constObject.find("key 2") - constObject.begin(), 1);
+
+    const vector<Pair>& pairs = object.pairs();
+    BOOST_CHECK_EQUAL(pairs.size(), object.size());
+    BOOST_CHECK_EQUAL(pairs[1].name_, "key 2");
+
+    Object copy = object;
+    BOOST_CHECK(copy == object);
+    Object moved = std::move(copy);
+    BOOST_CHECK_EQUAL(find_value(moved, "key 50").get_int64(), 50);
+    BOOST_CHECK(find_value(moved, "key 1").is_null());
+
+    Object small{ Pair("a", 1), Pair("b", 2) };
+    BOOST_CHECK_EQUAL(small.find("b")->value_.get_int64(), 2);
+    BOOST_CHECK(small.find("c") == small.end());
+}
+
+BOOST_AUTO_TEST_CASE(indexed_vector_objects_find_the_first_of_repeated_names)
+{
+    for (unsigned seed = 1; seed != 200; ++seed)
+    {
+        Object object;
+        unsigned r = seed;
+
+        for (int i = 0; i != 300; ++i)
+        {
+            r = r * 1103515245 + 12345;
+            object.emplace_back("key " + to_string((r >> 16) % 40), i);
+
+            if (i == 16)
+            {
+                object.find("key 0"); // builds the index, the next pairs grow it
+            }
+        }
+
+        const Object& constObject = object;
+
+        for (int n = 0; n != 40; ++n)
+        {
+            const string name = "key " + to_string(n);
+            const auto first = std::find_if(constObject.begin(), constObject.end(),
+                [&name](const Pair& pair) { return pair.name_ == name; });
+
+            BOOST_CHECK(constObject.find(name) == first);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(interned_strings_are_shared)
+{
+    String_pool<char> pool;
+    {
+        const Interned_string<char> a = pool.intern("name", 4);
+        const Interned_string<char> b = pool.intern("name", 4);
+        const Interned_string<char> c = pool.intern("other", 5);
+        const Interned_string<char> long_string = pool.intern(string(100, 'x').c_str(), 100);
+
+        BOOST_CHECK_EQUAL(a.data(), b.data());
+        BOOST_CHECK(a == b);
+        BOOST_CHECK(a != c);
+        BOOST_CHECK(a < c);
+        BOOST_CHECK(a == "name");
+        BOOST_CHECK(a == Interned_string<char>("name")); // of the shared pool
+        BOOST_CHECK_EQUAL(long_string.size(), 100u);
+        BOOST_CHECK_EQUAL(pool.size(), 2u); // long strings are not pooled
+        BOOST_CHECK_EQUAL(pool.collect(), 0u);
+    }
+    BOOST_CHECK_EQUAL(pool.collect(), 2u);
+    BOOST_CHECK_EQUAL(pool.size(), 0u);
+
+    static_assert(sizeof(iValue) <= 16, "interned strings are stored in the value");
+    static_assert(sizeof(iPair) <= 24, "a pair is a pointer and a value");
+
+    const iValue value = "interned";
+    const iValue copy = value;
+    BOOST_CHECK_EQUAL(copy.get_str().data(), value.get_str().data());
+    BOOST_CHECK(copy == value);
+}
+
+BOOST_AUTO_TEST_CASE(strings_can_be_interned_by_many_threads)
+{
+    String_pool<char> pool;
+    std::vector<std::vector<Interned_string<char>>> strings(4);
+    std::vector<std::thread> threads;
+
+    for (auto& thread_strings : strings)
+    {
+        threads.emplace_back([&pool, &thread_strings]() {
+            for (int i = 0; i != 10000; ++i)
+            {
+                const std::string s = "key " + to_string(i % 500);
+                thread_strings.push_back(pool.intern(s.data(), s.size()));
+            }
+        });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    BOOST_CHECK_EQUAL(pool.size(), 500u);
+
+    bool shared = true;
+
+    for (std::size_t i = 0; i != 10000; ++i)
+    {
+        shared = shared && strings[0][i].data() == strings[3][i].data();
+    }
+
+    BOOST_CHECK(shared);
+
+    strings.clear();
+    BOOST_CHECK_EQUAL(pool.collect(), 500u);
+}
+
+BOOST_AUTO_TEST_CASE(strings_can_be_dropped_while_the_pool_is_collected)
+{
+    String_pool<char> pool;
+    std::atomic<bool> done(false);
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t != 4; ++t)
+    {
+        threads.emplace_back([&pool]() {
+            for (int i = 0; i != 20000; ++i)
+            {
+                const std::string s = "key " + to_string(i % 50);
+                const Interned_string<char> interned = pool.intern(s.data(), s.size());
+                Interned_string<char> copy = interned; // both references dropped at once
+            }
+        });
+    }
+
+    std::thread collector([&pool, &done]() {
+        while (!done.load())
+        {
+            pool.collect();
+        }
+    });
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    done.store(true);
+    collector.join();
+
+    pool.collect();
+    BOOST_CHECK_EQUAL(pool.size(), 0u);
+}
+
 BOOST_DATA_TEST_CASE(can_check_if_is_uint64, IS_UINT64_TEST_DATA, data)
 {
     BOOST_CHECK_EQUAL(data.first.is_uint64(), data.second);
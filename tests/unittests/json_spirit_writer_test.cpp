@@ -4,19 +4,28 @@
 // json spirit version 4.08
 
 #include "stdafx.h"
+#include "json_spirit_reader_template.h"
 #include "json_spirit_writer_template.h"
 #include "test_utils.h"
+#include <cmath>
 #include <cstdint>
+#include <cstring>
 #include <limits>
+#include <random>
 #include <sstream>
+#include <vector>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
 
 using namespace json_spirit;
 using namespace std;
 using namespace boost;
 
-using ValueTypes = boost::mpl::list<Value, mValue, wValue, wmValue>;
+using ValueTypes = boost::mpl::list<Value, mValue, wValue, wmValue, hValue, whValue>;
 using ValuesVectorBased = boost::mpl::list<Value, mValue, wValue, wmValue>;
-using ValueVectorTypes = boost::mpl::list<Value, wValue>;
+using ValueVectorTypes = boost::mpl::list<Value, wValue, hValue, whValue>;
 using ValueMapTypes = boost::mpl::list<mValue, wmValue>;
 
 template<class Value>
@@ -39,11 +48,30 @@ void checkWriteStream(const Value& value, const std::string& expected, int flags
     BOOST_CHECK_EQUAL(actual, expected);
 }
 
+template<class Value>
+void checkWriteSinks(const Value& value, const std::string& expected, int flags = json_spirit::none)
+{
+    using Char = typename Value::String_type::value_type;
+    using Text = std::basic_string<Char>;
+
+    std::vector<Char> chars;
+    Append_sink<std::vector<Char>> appendSink(chars);
+    write_to_sink(value, appendSink, flags);
+    BOOST_CHECK_EQUAL(encoding_cast<std::string>(Text(chars.begin(), chars.end())), expected);
+
+    Char buffer[256];
+    Buffer_sink<Char> bufferSink(buffer, sizeof(buffer) / sizeof(buffer[0]));
+    write_to_sink(value, bufferSink, flags);
+    BOOST_REQUIRE(!bufferSink.overflowed());
+    BOOST_CHECK_EQUAL(encoding_cast<std::string>(Text(buffer, bufferSink.size())), expected);
+}
+
 template<class Value>
 void checkWrite(const Value& value, const std::string& expected, int flags = json_spirit::none)
 {
     checkWriteString(value, expected, flags);
     checkWriteStream(value, expected, flags);
+    checkWriteSinks(value, expected, flags);
 }
 
 template<class T>
@@ -129,9 +157,8 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(can_print_map_object_with_two_entries, T, ValueMap
 BOOST_AUTO_TEST_CASE_TEMPLATE(can_print_array, T, ValueTypes)
 {
     using B = Builder<T>;
-    // TODO: precision lost when printing 2.4 - it prints 2.39999...
-    T value = B::array(B::string(""), B::string("\""), B::string("abcd\""), B::string("28"), 28, 0, -1, 2.5);
-    checkWrite(value, R"***(["","\"","abcd\"","28",28,0,-1,2.5])***");
+    T value = B::array(B::string(""), B::string("\""), B::string("abcd\""), B::string("28"), 28, 0, -1, 2.4);
+    checkWrite(value, R"***(["","\"","abcd\"","28",28,0,-1,2.4])***");
 
     T value2 = B::array(true, false, true);
     checkWrite(value2, R"***([true,false,true])***");
@@ -211,7 +238,7 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(can_print_object_with_real_pairs, T, ValueTypes)
         { B::key("name_6"), B::value(-1.0) },
         { B::key("name_7"), B::value(1.001) }
     };
-    checkWrite(value2, R"***({"name_5":1.0,"name_6":-1.0,"name_7":1.0009999999999999})***");
+    checkWrite(value2, R"***({"name_5":1.0,"name_6":-1.0,"name_7":1.001})***");
 
     T value3 = Object{
         { B::key("name_08"), B::value(10.1) },
@@ -226,7 +253,7 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(can_print_object_with_real_pairs, T, ValueTypes)
         { B::key("name_13"), B::value(1e-10) },
         { B::key("name_14"), B::value(123e65) },
     };
-    checkWrite(value4, R"***({"name_13":1.0e-10,"name_14":1.2300000000000001e+67})***");
+    checkWrite(value4, R"***({"name_13":1.0e-10,"name_14":1.23e+67})***");
 
     // 123e65
 }
@@ -243,8 +270,151 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(can_print_object_with_null_pairs, T, ValueTypes)
     checkWrite(value, R"***({"name_1":null,"name_2":null,"name_3":null})***");
 }
 
+BOOST_AUTO_TEST_CASE(buffer_sink_reports_overflow)
+{
+    const Value value = Array{ 1, "two", 3.5 };
+    const std::string expected = "[1,\"two\",3.5]";
+
+    char buffer[8];
+    Buffer_sink<char> sink(buffer, sizeof(buffer));
+    write_to_sink(value, sink);
+    BOOST_CHECK(sink.overflowed());
+    BOOST_CHECK_EQUAL(sink.required_size(), expected.size());
+    BOOST_CHECK_EQUAL(std::string(buffer, sink.size()), expected.substr(0, sizeof(buffer)));
+
+    std::string text = "response: ";
+    Append_sink<std::string> appendSink(text);
+    write_to_sink(value, appendSink);
+    BOOST_CHECK_EQUAL(text, "response: " + expected);
+}
+
+#ifndef _WIN32
+BOOST_AUTO_TEST_CASE(fd_sink_writes_through_its_buffer)
+{
+    int fds[2];
+    BOOST_REQUIRE_EQUAL(pipe(fds), 0);
+
+    const Value value = Array{ "a long enough string", 12345, Object{ { "k", true } } };
+    const std::string expected = write_string(value);
+    {
+        Fd_sink sink(fds[1], 4); // smaller than some tokens
+        write_to_sink(value, sink);
+        BOOST_CHECK(sink.flush());
+        BOOST_CHECK_EQUAL(sink.error(), 0);
+    }
+    close(fds[1]);
+
+    std::string actual;
+    char buffer[64];
+    for (ssize_t n; (n = read(fds[0], buffer, sizeof(buffer))) > 0;)
+    {
+        actual.append(buffer, n);
+    }
+    close(fds[0]);
+    BOOST_CHECK_EQUAL(actual, expected);
+
+    Fd_sink badSink(-1);
+    write_to_sink(value, badSink);
+    BOOST_CHECK(!badSink.flush());
+    BOOST_CHECK_EQUAL(badSink.error(), EBADF);
+}
+#endif
+
+BOOST_AUTO_TEST_CASE(writing_to_a_failed_stream_writes_nothing)
+{
+    std::ostringstream os;
+    os.setstate(std::ios_base::failbit);
+    write_stream(Value(Array{ 1, 2 }), os);
+    BOOST_CHECK(os.str().empty());
+    BOOST_CHECK(os.fail());
+}
+
+BOOST_AUTO_TEST_CASE(doubles_are_written_with_the_shortest_digits_that_read_back)
+{
+    checkWrite(Value(Array{ 0.1, 0.3, -0.0, 1e-4, 1e-5, 1e16, 1e17 }),
+        "[0.1,0.3,-0.0,0.0001,1.0e-05,10000000000000000.0,1.0e+17]");
+    checkWrite(Value(Array{ 5e-324, 2.2250738585072014e-308, 1.7976931348623157e308 }),
+        "[5.0e-324,2.2250738585072014e-308,1.7976931348623157e+308]");
+    checkWrite(wValue(wArray{ 123456.789, -2.5e-3 }), "[123456.789,-0.0025]");
+
+    std::mt19937_64 random(17);
+    for (int i = 0; i < 10000; ++i)
+    {
+        const boost::uint64_t bits = random();
+        double d;
+        std::memcpy(&d, &bits, sizeof(d));
+        if (!std::isfinite(d))
+        {
+            continue;
+        }
+
+        Value read;
+        BOOST_REQUIRE(read_string(write_string(Value(d)), read));
+        BOOST_CHECK_EQUAL(read.get_real(), d);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(integers_are_written_with_all_their_digits)
+{
+    checkWrite(Value(Array{ 0, 9, 10, -1, -99, 100 }), "[0,9,10,-1,-99,100]");
+    checkWrite(Value(Array{ (std::numeric_limits<int64_t>::min)(), (std::numeric_limits<uint64_t>::max)() }),
+        "[-9223372036854775808,18446744073709551615]");
+    checkWrite(wValue(wArray{ -1234567, 890 }), "[-1234567,890]");
+
+    uint64_t power = 1;
+    for (int i = 0; i != 20; ++i, power *= 10)
+    {
+        BOOST_CHECK_EQUAL(write_string(Value(power - 1)), std::to_string(power - 1));
+        BOOST_CHECK_EQUAL(write_string(Value(power)), std::to_string(power));
+        BOOST_CHECK_EQUAL(write_string(Value(-static_cast<int64_t>(power / 10 + 1))), std::to_string(-static_cast<int64_t>(power / 10 + 1)));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(can_escape_non_printable_ascii)
+{
+    checkWrite(Value("\"\\/\b\f\n\r\t"), R"***("\"\\/\b\f\n\r\t")***");
+    checkWrite(Value(std::string("\0\x01\x1F \x7F~", 6)), R"***("\u0000\u0001\u001F \u007F~")***");
+    checkWrite(wValue(std::wstring(L"\x01\"\x7F", 3)), R"***("\u0001\"\u007F")***");
+
+    checkWrite(Value(std::string("\x01\t\x7F", 3)), "\"\x01\\t\x7F\"", raw_utf8);
+}
+
+BOOST_AUTO_TEST_CASE(escapes_are_found_anywhere_in_long_strings)
+{
+    for (std::size_t i = 0; i != 70; ++i)
+    {
+        std::string s(70, 'a');
+        std::string expected = '"' + s + '"';
+        s[i] = '\n';
+        expected.replace(i + 1, 1, "\\n");
+
+        BOOST_CHECK_EQUAL(write_string(Value(s)), expected);
+        BOOST_CHECK_EQUAL(write_string(Value(s), raw_utf8), expected);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(can_escape_unicode)
+{
+    const std::string text = "caf\xC3\xA9 \xE2\x82\xAC \xF0\x9F\x98\x80";
+
+    checkWrite(Value(text), '"' + text + '"');
+    checkWrite(Value(text), R"***("caf\u00E9 \u20AC \uD83D\uDE00")***", always_escape_nonascii);
+    checkWrite(Value(text), '"' + text + '"', raw_utf8 | always_escape_nonascii);
+
+    checkWrite(wValue(std::wstring(L"caf\u00E9 \U0001F600")), R"***("caf\u00E9 \uD83D\uDE00")***", always_escape_nonascii);
+}
+
+BOOST_AUTO_TEST_CASE(bytes_of_invalid_utf8_are_escaped_one_by_one)
+{
+    checkWrite(Value("caf\xE9"), R"***("caf\u00E9")***"); // Latin-1
+    checkWrite(Value("\xE2\x82"), R"***("\u00E2\u0082")***"); // truncated
+    checkWrite(Value("\xC0\xAF"), R"***("\u00C0\u00AF")***"); // overlong
+    checkWrite(Value("\xED\xA0\x80"), R"***("\u00ED\u00A0\u0080")***"); // surrogate
+    checkWrite(Value("\xF4\x90\x80\x80"), R"***("\u00F4\u0090\u0080\u0080")***"); // beyond U+10FFFF
+    checkWrite(Value("\xC3\xA9\xA9\xC3\xA9"), "\"\xC3\xA9\\u00A9\xC3\xA9\"");
+
+    checkWrite(Value("caf\xE9"), "\"caf\xE9\"", raw_utf8);
+}
+
 // TODO: add tests for remove_trailing_zeros
-// TODO: add tests for escaping Unicode
-// TODO: add tests for escaping non-printable ASCII (with codes 0..31)
-// TODO: add tests for doubles precision
 BOOST_AUTO_TEST_SUITE_END()
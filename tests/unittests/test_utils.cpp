@@ -52,6 +52,18 @@ std::ostream& json_spirit::operator<<(std::ostream& out, const json_spirit::wmVa
     return out;
 }
 
+std::ostream& json_spirit::operator<<(std::ostream& out, const json_spirit::hValue& value)
+{
+    out << json_spirit::write_string(value, json_spirit::pretty_print | json_spirit::single_line_arrays);
+    return out;
+}
+
+std::ostream& json_spirit::operator<<(std::ostream& out, const json_spirit::whValue& value)
+{
+    out << wstring_to_utf8(json_spirit::write_string(value, json_spirit::pretty_print | json_spirit::single_line_arrays));
+    return out;
+}
+
 std::ostream& json_spirit::operator<<(std::ostream& out, json_spirit::Value_type type)
 {
     out << json_spirit::value_type_to_string(type);